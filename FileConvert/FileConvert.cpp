@@ -36,6 +36,9 @@ const unsigned int PCM_BLOCK_SIZE  = 160U;		// 20ms at 8000 samples/sec
 const unsigned int PCM_BLOCK_TIME  = 20U;
 const unsigned int PCM_NO_CHANNELS = 1U;
 
+// All of the conversion is done in the first transcoder session
+const uint8_t FILE_SESSION_ID = 0U;
+
 uint8_t convertMode(const char* text)
 {
 	if (::strcmp(text, "dstar") == 0)
@@ -279,11 +282,12 @@ bool CFileConvert::open()
 	}
 
 	uint8_t command[10U];
-	::memcpy(command + 0U, SET_MODE_HEADER, SET_MODE_HEADER_LEN);
-	command[INPUT_MODE_POS]  = m_inMode;
-	command[OUTPUT_MODE_POS] = m_outMode;
+	::memcpy(command + 0U, SESSION_SET_MODE_HEADER, SESSION_SET_MODE_HEADER_LEN);
+	command[SESSION_ID_POS]          = FILE_SESSION_ID;
+	command[SESSION_INPUT_MODE_POS]  = m_inMode;
+	command[SESSION_OUTPUT_MODE_POS] = m_outMode;
 
-	ret2 = m_connection->write(command, SET_MODE_LEN);
+	ret2 = m_connection->write(command, SESSION_SET_MODE_LEN);
 	if (ret2 <= 0) {
 		::fprintf(stderr, "Error writing data to the transcoder\n");
 		return false;
@@ -297,12 +301,12 @@ bool CFileConvert::open()
 	}
 
 	switch (buffer[TYPE_POS]) {
-	case TYPE_NAK:
-		::fprintf(stderr, "NAK returned for set mode - %u\n", buffer[NAK_ERROR_POS]);
+	case TYPE_SESSION_NAK:
+		::fprintf(stderr, "NAK returned for set mode - %u\n", buffer[SESSION_NAK_ERROR_POS]);
 		m_connection->close();
 		return false;
 
-	case TYPE_ACK:
+	case TYPE_SESSION_ACK:
 		::fprintf(stdout, "Conversion modes - set\n");
 		return true;
 
@@ -366,6 +370,76 @@ uint16_t CFileConvert::read(uint8_t* buffer, uint16_t timeout)
 	}
 }
 
+// Send up to MAX_BATCH_FRAMES frames in one message, the converted frames come back in the same order.
+// A frame that the transcoder could not convert is replaced by silence so that the timing is kept.
+bool CFileConvert::transcode(const uint8_t* in, unsigned int inLength, unsigned int count, uint8_t* out, unsigned int outLength)
+{
+	assert(in != nullptr);
+	assert(out != nullptr);
+	assert((count > 0U) && (count <= MAX_BATCH_FRAMES));
+
+	uint8_t buffer[BATCH_HEADER_LEN + MAX_BATCH_FRAMES * (PCM_DATA_LENGTH + 1U)];
+
+	uint16_t length = BATCH_HEADER_LEN + count * inLength;
+
+	buffer[MARKER_POS]                  = MARKER;
+	buffer[LENGTH_LSB_POS]              = (length >> 0) & 0xFFU;
+	buffer[LENGTH_MSB_POS]              = (length >> 8) & 0xFFU;
+	buffer[TYPE_POS]                    = TYPE_DATA_BATCH;
+	buffer[SESSION_ID_POS]              = FILE_SESSION_ID;
+	buffer[BATCH_COUNT_POS]             = count;
+	buffer[BATCH_FRAME_LENGTH_POS + 0U] = (inLength >> 0) & 0xFFU;
+	buffer[BATCH_FRAME_LENGTH_POS + 1U] = (inLength >> 8) & 0xFFU;
+
+	::memcpy(buffer + BATCH_DATA_START_POS, in, count * inLength);
+
+	int16_t ret = m_connection->write(buffer, length);
+	if (ret <= 0) {
+		::fprintf(stderr, "Error writing the data to the transcoder\n");
+		return false;
+	}
+
+	uint16_t len = read(buffer, 300U);
+	if (len == 0U) {
+		::fprintf(stderr, "Transcode read timeout (300 ms)\n");
+		return false;
+	}
+
+	switch (buffer[TYPE_POS]) {
+	case TYPE_SESSION_NAK:
+		::fprintf(stderr, "NAK returned for transcoding - %u\n", buffer[SESSION_NAK_ERROR_POS]);
+		return false;
+
+	case TYPE_DATA_BATCH:
+		break;
+
+	default:
+		::fprintf(stderr, "Unknown response from the transcoder to transcoding - 0x%02X\n", buffer[TYPE_POS]);
+		return false;
+	}
+
+	if (buffer[BATCH_COUNT_POS] != count) {
+		::fprintf(stderr, "Transcoder returned %u frames instead of %u\n", buffer[BATCH_COUNT_POS], count);
+		return false;
+	}
+
+	unsigned int frameLength = (buffer[BATCH_FRAME_LENGTH_POS + 0U] << 0) | (buffer[BATCH_FRAME_LENGTH_POS + 1U] << 8);
+
+	uint16_t pos = BATCH_DATA_START_POS;
+	for (unsigned int i = 0U; i < count; i++) {
+		uint8_t err = buffer[pos++];
+		if (err == 0x00U) {
+			::memcpy(out + i * outLength, buffer + pos, outLength);
+			pos += frameLength;
+		} else {
+			::fprintf(stderr, "Transcoding error for a frame - %u\n", err);
+			::memset(out + i * outLength, 0x00U, outLength);
+		}
+	}
+
+	return true;
+}
+
 // The transcoder can do PCM to PCM, but it seems a bit silly to use it for such a simple task.
 bool CFileConvert::convertPCMtoPCM()
 {
@@ -455,47 +529,35 @@ bool CFileConvert::convertPCMtoDV()
 
 	unsigned int frames = 0U;
 
-	float buffer1[PCM_BLOCK_SIZE];
-	unsigned int length = reader.read(buffer1, PCM_BLOCK_SIZE);
-	while (length > 0U) {
-		int16_t buffer2[PCM_BLOCK_SIZE];
-		for (unsigned int i = 0U; i < PCM_BLOCK_SIZE; i++)
-			buffer2[i] = int16_t(buffer1[i] * 32768.0F + 0.5F);
+	for (;;) {
+		uint8_t buffer1[MAX_BATCH_FRAMES * PCM_DATA_LENGTH];
 
-		uint8_t buffer3[PCM_DATA_LEN];
-		::memcpy(buffer3 + 0U, PCM_DATA_HEADER, DATA_HEADER_LEN);
-		::memcpy(buffer3 + DATA_START_POS, buffer2, PCM_DATA_LENGTH);
+		unsigned int count = 0U;
+		while (count < MAX_BATCH_FRAMES) {
+			float buffer2[PCM_BLOCK_SIZE];
+			unsigned int length = reader.read(buffer2, PCM_BLOCK_SIZE);
+			if (length == 0U)
+				break;
 
-		int16_t ret = m_connection->write(buffer3, PCM_DATA_LEN);
-		if (ret <= 0) {
-			::fprintf(stderr, "Error writing the data to the transcoder\n");
-			return false;
-		}
+			int16_t* buffer3 = (int16_t*)(buffer1 + count * PCM_DATA_LENGTH);
+			for (unsigned int i = 0U; i < PCM_BLOCK_SIZE; i++)
+				buffer3[i] = int16_t(buffer2[i] * 32768.0F + 0.5F);
 
-		uint16_t len = read(buffer3, 200U);
-		if (len == 0U) {
-			::fprintf(stderr, "Transcode read timeout (200 me)\n");
-			return false;
+			count++;
 		}
 
-		switch (buffer3[TYPE_POS]) {
-		case TYPE_NAK:
-			::fprintf(stderr, "NAK returned for transcoding - %u\n", buffer3[NAK_ERROR_POS]);
-			return false;
-
-		case TYPE_DATA:
+		if (count == 0U)
 			break;
 
-		default:
-			::fprintf(stderr, "Unknown response from the transcoder to transcoding - 0x%02X\n", buffer3[TYPE_POS]);
+		uint8_t buffer4[MAX_BATCH_FRAMES * 50U];
+		ret = transcode(buffer1, PCM_DATA_LENGTH, count, buffer4, dvLength);
+		if (!ret)
 			return false;
-		}
-
-		frames++;
 
-		writer.write(buffer3 + DATA_START_POS, dvLength);
+		frames += count;
 
-		length = reader.read(buffer1, PCM_BLOCK_SIZE);
+		for (unsigned int i = 0U; i < count; i++)
+			writer.write(buffer4 + i * dvLength, dvLength);
 	}
 
 	reader.close();
@@ -523,56 +585,38 @@ bool CFileConvert::convertDVtoPCM()
 	}
 
 	unsigned int dvLength = getBlockLength(m_inMode);
-	const uint8_t* header = getDataHeader(m_inMode);
 
 	CStopWatch stopWatch;
 	stopWatch.start();
 
 	unsigned int frames = 0U;
 
-	uint8_t buffer1[50U];
-	unsigned int length = reader.read(buffer1, dvLength);
-	while (length > 0U) {
-		uint8_t buffer2[PCM_DATA_LEN];
-		::memcpy(buffer2 + 0U, header, DATA_HEADER_LEN);
-		::memcpy(buffer2 + DATA_START_POS, buffer1, dvLength);
-
-		int16_t ret = m_connection->write(buffer2, dvLength + DATA_HEADER_LEN);
-		if (ret <= 0) {
-			::fprintf(stderr, "Error writing the data to the transcoder\n");
-			return false;
-		}
-
-		uint16_t len = read(buffer2, 200U);
-		if (len == 0U) {
-			::fprintf(stderr, "Transcode read timeout (200 me)\n");
-			return false;
-		}
+	for (;;) {
+		uint8_t buffer1[MAX_BATCH_FRAMES * 50U];
 
-		switch (buffer2[TYPE_POS]) {
-		case TYPE_NAK:
-			::fprintf(stderr, "NAK returned for transcoding - %u\n", buffer2[NAK_ERROR_POS]);
-			return false;
+		unsigned int count = 0U;
+		while ((count < MAX_BATCH_FRAMES) && (reader.read(buffer1 + count * dvLength, dvLength) > 0U))
+			count++;
 
-		case TYPE_DATA:
+		if (count == 0U)
 			break;
 
-		default:
-			::fprintf(stderr, "Unknown response from the transcoder to transcoding - 0x%02X\n", buffer2[TYPE_POS]);
+		uint8_t buffer2[MAX_BATCH_FRAMES * PCM_DATA_LENGTH];
+		ret = transcode(buffer1, dvLength, count, buffer2, PCM_DATA_LENGTH);
+		if (!ret)
 			return false;
-		}
-
-		frames++;
 
-		int16_t* buffer3 = (int16_t*)(buffer2 + DATA_START_POS);
+		frames += count;
 
-		float buffer4[PCM_BLOCK_SIZE];
-		for (unsigned int i = 0U; i < PCM_BLOCK_SIZE; i++)
-			buffer4[i] = float(buffer3[i]) / 32768.0F;
+		for (unsigned int n = 0U; n < count; n++) {
+			int16_t* buffer3 = (int16_t*)(buffer2 + n * PCM_DATA_LENGTH);
 
-		writer.write(buffer4, PCM_BLOCK_SIZE);
+			float buffer4[PCM_BLOCK_SIZE];
+			for (unsigned int i = 0U; i < PCM_BLOCK_SIZE; i++)
+				buffer4[i] = float(buffer3[i]) / 32768.0F;
 
-		length = reader.read(buffer1, dvLength);
+			writer.write(buffer4, PCM_BLOCK_SIZE);
+		}
 	}
 
 	reader.close();
@@ -601,50 +645,31 @@ bool CFileConvert::convertDVtoDV()
 
 	unsigned int inLength  = getBlockLength(m_inMode);
 	unsigned int outLength = getBlockLength(m_outMode);
-	const uint8_t* header  = getDataHeader(m_inMode);
 
 	CStopWatch stopWatch;
 	stopWatch.start();
 
 	unsigned int frames = 0U;
 
-	uint8_t buffer1[50U];
-	unsigned int length = reader.read(buffer1, inLength);
-	while (length > 0U) {
-		uint8_t buffer2[50U];
-		::memcpy(buffer2 + 0U, header, DATA_HEADER_LEN);
-		::memcpy(buffer2 + DATA_START_POS, buffer1, inLength);
-
-		int16_t ret = m_connection->write(buffer2, inLength + DATA_HEADER_LEN);
-		if (ret <= 0) {
-			::fprintf(stderr, "Error writing the data to the transcoder\n");
-			return false;
-		}
-
-		uint16_t len = read(buffer2, 300U);
-		if (len == 0U) {
-			::fprintf(stderr, "Transcode read timeout (300 ms)\n");
-			return false;
-		}
+	for (;;) {
+		uint8_t buffer1[MAX_BATCH_FRAMES * 50U];
 
-		switch (buffer2[TYPE_POS]) {
-		case TYPE_NAK:
-			::fprintf(stderr, "NAK returned for transcoding - %u\n", buffer2[NAK_ERROR_POS]);
-			return false;
+		unsigned int count = 0U;
+		while ((count < MAX_BATCH_FRAMES) && (reader.read(buffer1 + count * inLength, inLength) > 0U))
+			count++;
 
-		case TYPE_DATA:
+		if (count == 0U)
 			break;
 
-		default:
-			::fprintf(stderr, "Unknown response from the transcoder to transcoding - 0x%02X\n", buffer2[TYPE_POS]);
+		uint8_t buffer2[MAX_BATCH_FRAMES * 50U];
+		ret = transcode(buffer1, inLength, count, buffer2, outLength);
+		if (!ret)
 			return false;
-		}
-
-		frames++;
 
-		writer.write(buffer2 + DATA_START_POS, outLength);
+		frames += count;
 
-		length = reader.read(buffer1, inLength);
+		for (unsigned int i = 0U; i < count; i++)
+			writer.write(buffer2 + i * outLength, outLength);
 	}
 
 	reader.close();
@@ -677,26 +702,6 @@ unsigned int CFileConvert::getBlockLength(uint8_t mode) const
 	}
 }
 
-const uint8_t* CFileConvert::getDataHeader(uint8_t mode) const
-{
-	switch (mode) {
-	case MODE_DSTAR:
-		return DSTAR_DATA_HEADER;
-	case MODE_DMR_NXDN:
-		return DMR_NXDN_DATA_HEADER;
-	case MODE_YSFDN:
-		return YSFDN_DATA_HEADER;
-	case MODE_IMBE:
-		return IMBE_DATA_HEADER;
-	case MODE_IMBE_FEC:
-		return IMBE_FEC_DATA_HEADER;
-	case MODE_CODEC2_3200:
-		return CODEC2_3200_DATA_HEADER;
-	default:
-		return PCM_DATA_HEADER;
-	}
-}
-
 std::string CFileConvert::getFileSignature(uint8_t mode) const
 {
 	switch (mode) {
@@ -42,9 +42,9 @@ private:
 	bool open();
 	bool validateOptions() const;
 	uint16_t read(uint8_t* buffer, uint16_t timeout);
+	bool transcode(const uint8_t* in, unsigned int inLength, unsigned int count, uint8_t* out, unsigned int outLength);
 	std::string getFileSignature(uint8_t mode) const;
 	unsigned int getBlockLength(uint8_t mode) const;
-	const uint8_t* getDataHeader(uint8_t mode) const;
 	bool convertPCMtoPCM();
 	bool convertPCMtoDV();
 	bool convertDVtoPCM();
@@ -56,6 +56,17 @@ const uint8_t TYPE_SET_MODE         = 0x02U;
 const uint8_t TYPE_ACK              = 0x03U;
 const uint8_t TYPE_NAK              = 0x04U;
 const uint8_t TYPE_DATA             = 0x05U;
+const uint8_t TYPE_SESSION_SET_MODE = 0x06U;
+const uint8_t TYPE_SESSION_ACK      = 0x07U;
+const uint8_t TYPE_SESSION_NAK      = 0x08U;
+const uint8_t TYPE_SESSION_DATA     = 0x09U;
+const uint8_t TYPE_DATA_BATCH       = 0x0AU;
+const uint8_t TYPE_SESSION_CREDITS  = 0x0BU;
+const uint8_t TYPE_SESSION_DATA_EXT = 0x0CU;
+const uint8_t TYPE_GET_STATS        = 0x0DU;
+const uint8_t TYPE_GET_TRACE        = 0x0EU;
+const uint8_t TYPE_SESSION_SET_FANOUT  = 0x0FU;
+const uint8_t TYPE_SESSION_FANOUT_DATA = 0x10U;
 
 const uint8_t  GET_VERSION[]   = { MARKER, 0x04U, 0x00U, TYPE_GET_VERSION };
 const uint16_t GET_VERSION_LEN = 4U;
@@ -67,6 +78,10 @@ const uint8_t  SET_MODE_HEADER[]   = { MARKER, 0x06U, 0x00U, TYPE_SET_MODE };
 const uint16_t SET_MODE_HEADER_LEN = 4U;
 const uint16_t SET_MODE_LEN        = 6U;
 
+const uint8_t  SESSION_SET_MODE_HEADER[]   = { MARKER, 0x07U, 0x00U, TYPE_SESSION_SET_MODE };
+const uint16_t SESSION_SET_MODE_HEADER_LEN = 4U;
+const uint16_t SESSION_SET_MODE_LEN        = 7U;
+
 const uint16_t DATA_HEADER_LEN = 4U;
 
 const uint8_t  DSTAR_DATA_HEADER[] = { MARKER, 0x0DU, 0x00U, TYPE_DATA };
@@ -99,7 +114,7 @@ const uint16_t DATA_START_POS = 4U;
 // Get Version layout and data
 const uint16_t GET_VERSION_PROTOCOL_POS = 4U;
 const uint16_t GET_VERSION_HARWARE_POS  = 5U;
-const uint8_t  PROTOCOL_VERSION = 1U;
+const uint8_t  PROTOCOL_VERSION = 2U;
 
 // Get Capabilities layout and data
 const uint16_t GET_CAPABILITIES_AMBE_TYPE_POS = 4U;
@@ -107,6 +122,7 @@ const uint8_t  NO_AMBE_CHIP        = 0U;
 const uint8_t  HAS_1AMBE3000_CHIP  = 1U;
 const uint8_t  HAS_2AMBE3000_CHIPS = 2U;
 const uint8_t  HAS_1AMBE3003_CHIP  = 3U;
+const uint16_t GET_CAPABILITIES_SESSIONS_POS = 7U;
 
 // Set Mode layout
 const uint16_t INPUT_MODE_POS  = 4U;
@@ -115,4 +131,59 @@ const uint16_t OUTPUT_MODE_POS = 5U;
 // NAK layout
 const uint16_t NAK_ERROR_POS = 4U;
 
+// Session layout, the session id follows the type
+const uint16_t SESSION_ID_POS          = 4U;
+const uint16_t SESSION_INPUT_MODE_POS  = 5U;
+const uint16_t SESSION_OUTPUT_MODE_POS = 6U;
+const uint16_t SESSION_NAK_ERROR_POS   = 5U;
+const uint16_t SESSION_DATA_START_POS  = 5U;
+
+// Batch layout, the same in both directions except that each returned frame is prefixed by an error code
+const uint16_t BATCH_COUNT_POS        = 5U;
+const uint16_t BATCH_FRAME_LENGTH_POS = 6U;
+const uint16_t BATCH_DATA_START_POS   = 8U;
+const uint16_t BATCH_HEADER_LEN       = 8U;
+const unsigned int MAX_BATCH_FRAMES   = 8U;
+
+// Credits layout, a non-zero enable byte turns on credit reports for the session
+const uint16_t CREDITS_ENABLE_POS = 5U;
+const uint16_t CREDITS_COUNT_POS  = 5U;
+
+// Extended data layout, the host sequence number is echoed back followed by the device timestamps
+// in microseconds taken at receive, AMBE write, AMBE read and transmit, zero when not applicable
+const uint16_t DATA_EXT_SEQ_POS          = 5U;
+const uint16_t DATA_EXT_REQ_START_POS    = 7U;
+const uint16_t DATA_EXT_RX_TIME_POS      = 7U;
+const uint16_t DATA_EXT_AMBE_WRITE_POS   = 11U;
+const uint16_t DATA_EXT_AMBE_READ_POS    = 15U;
+const uint16_t DATA_EXT_TX_TIME_POS      = 19U;
+const uint16_t DATA_EXT_REP_START_POS    = 23U;
+const uint16_t DATA_EXT_NAK_SEQ_POS      = 6U;
+
+// Get Stats layout, an optional request byte with bit 0 set clears the counters after reading. The
+// reply holds the session count then little endian 32 bit values: core clock, frames in and out per
+// session, NAKs by error code 0 to 7, FEC bit corrections, DVSI packets sent and received, packets held
+// while RTS is busy, maximum loop time in microseconds, the count, maximum and average cycles for
+// processor input, processor output, IMBE encode and Codec2 encode, then the number of DVSI channels
+// as one byte, three unless the board has more than one AMBE3003, and for each channel the frames
+// written to it and the milliseconds that it has been held by a session
+const uint16_t STATS_SESSIONS_POS = 4U;
+const uint16_t STATS_CLOCK_POS    = 5U;
+const uint16_t STATS_FRAMES_POS   = 9U;
+const uint8_t  STATS_RESET        = 0x01U;
+
+// Get Trace layout, the number of dropped records then each record as a little endian 32 bit
+// microsecond timestamp, the argument count, little endian 16 bit arguments and the NUL terminated text
+const uint16_t TRACE_DROPPED_POS    = 4U;
+const uint16_t TRACE_RECORD_POS     = 6U;
+
+// Fan-out layout, the request has the input mode, the number of outputs and then each output mode.
+// Each output of a frame is returned separately, tagged with its output mode.
+const uint16_t FANOUT_INPUT_MODE_POS  = 5U;
+const uint16_t FANOUT_COUNT_POS       = 6U;
+const uint16_t FANOUT_OUTPUTS_POS     = 7U;
+const uint16_t FANOUT_DATA_MODE_POS   = 5U;
+const uint16_t FANOUT_DATA_START_POS  = 6U;
+const unsigned int MAX_FANOUT_OUTPUTS = 4U;
+
 #endif
@@ -49,12 +49,12 @@ const uint16_t NAK5_LEN = 5U;
 
 const uint8_t  GET_VERSION_REQ[]   = { MARKER, 0x04U, 0x00U, 0x00U};
 const uint16_t GET_VERSION_REQ_LEN = 4U;
-const uint8_t  GET_VERSION_REP[]   = { MARKER, 0x2BU, 0x00U, 0x00U, 0x01U, 0x32U, 0x30U, 0x32U };
+const uint8_t  GET_VERSION_REP[]   = { MARKER, 0x2BU, 0x00U, 0x00U, 0x02U, 0x32U, 0x30U, 0x32U };
 const uint16_t GET_VERSION_REP_LEN = 8U;
 
 const uint8_t  GET_CAPABILITIES_REQ[]   = { MARKER, 0x04U, 0x00U, 0x01U };
 const uint16_t GET_CAPABILITIES_REQ_LEN = 4U;
-const uint8_t  GET_CAPABILITIES_REP[]   = { MARKER, 0x07U, 0x00U, 0x01U };
+const uint8_t  GET_CAPABILITIES_REP[]   = { MARKER, 0x08U, 0x00U, 0x01U };
 const uint16_t GET_CAPABILITIES_REP_LEN = 4U;
 
 const uint8_t  PCM_DATA[] = { MARKER, 0x44U, 0x01U, 0x05U, 0x44U, 0xE3U, 0x1EU, 0xE3U, 0x1EU, 0xE5U, 0x97U, 0xF1U, 0x61U, 0x11U,
@@ -400,6 +400,138 @@ const uint16_t MODEQF_DATA_REQ_LEN = 20U;
 const uint8_t  MODEQF_DATA_REP[] = { MARKER, 0x4BU, 0x01U, 0x05U, 0x61U, 0x01U, 0x43U, 0x02U, 0x41U, 0x00U, 0xA0U };
 const uint16_t MODEQF_DATA_REP_LEN = 11U;
 
+/* Sessions */
+
+// Session 1 DMR/NXDN to DMR/NXDN Mode Set
+const uint8_t  SET_SESSIONA_REQ[]   = { MARKER, 0x07U, 0x00U, 0x06U, 0x01U, 0x02U, 0x02U };
+const uint16_t SET_SESSIONA_REQ_LEN = 7U;
+
+const uint8_t  SESSIONA_ACK[]   = { MARKER, 0x05U, 0x00U, 0x07U, 0x01U };
+const uint16_t SESSIONA_ACK_LEN = 5U;
+
+const uint8_t  SESSIONA_DATA[]       = { MARKER, 0x0EU, 0x00U, 0x09U, 0x01U, 0xA6U, 0xCBU, 0x80U, 0x27U, 0x20U, 0x4FU, 0x9BU, 0xCBU, 0xF3U };
+const uint16_t SESSIONA_DATA_REQ_LEN = 14U;
+const uint16_t SESSIONA_DATA_REP_LEN = 5U;
+
+// Session 1 DMR/NXDN with sequence number 0x1234, the reply carries the four device timestamps
+const uint8_t  SESSIONA_DATA_EXT_REQ[]   = { MARKER, 0x10U, 0x00U, 0x0CU, 0x01U, 0x34U, 0x12U, 0xA6U, 0xCBU, 0x80U, 0x27U, 0x20U, 0x4FU, 0x9BU, 0xCBU, 0xF3U };
+const uint16_t SESSIONA_DATA_EXT_REQ_LEN = 16U;
+
+const uint8_t  SESSIONA_DATA_EXT_REP[]   = { MARKER, 0x20U, 0x00U, 0x0CU, 0x01U, 0x34U, 0x12U };
+const uint16_t SESSIONA_DATA_EXT_REP_LEN = 7U;
+
+// Drain the trace records, the reply length varies
+const uint8_t  GET_TRACE_REQ[]   = { MARKER, 0x04U, 0x00U, 0x0EU };
+const uint16_t GET_TRACE_REQ_LEN = 4U;
+
+// Statistics with three sessions, the reply values vary and its length depends on the number of DVSI channels
+const uint8_t  GET_STATS_REQ[]   = { MARKER, 0x04U, 0x00U, 0x0DU };
+const uint16_t GET_STATS_REQ_LEN = 4U;
+
+// Where the number of DVSI channels is in the reply with three sessions, then each channel has two values
+const uint16_t GET_STATS_CHANNELS_POS = 133U;
+
+// Session 2 PCM to PCM Mode Set
+const uint8_t  SET_SESSIONB_REQ[]   = { MARKER, 0x07U, 0x00U, 0x06U, 0x02U, 0xFFU, 0xFFU };
+const uint16_t SET_SESSIONB_REQ_LEN = 7U;
+
+const uint8_t  SESSIONB_ACK[]   = { MARKER, 0x05U, 0x00U, 0x07U, 0x02U };
+const uint16_t SESSIONB_ACK_LEN = 5U;
+
+const uint8_t  SESSIONB_DATA[]       = { MARKER, 0x0EU, 0x00U, 0x09U, 0x02U, 0xA6U, 0xCBU, 0x80U, 0x27U, 0x20U, 0x4FU, 0x9BU, 0xCBU, 0xF3U };
+const uint16_t SESSIONB_DATA_REQ_LEN = 14U;
+const uint16_t SESSIONB_DATA_REP_LEN = 14U;
+
+// Session 1 credit reports
+const uint8_t  SESSIONA_CREDITS_ON_REQ[]   = { MARKER, 0x06U, 0x00U, 0x0BU, 0x01U, 0x01U };
+const uint16_t SESSIONA_CREDITS_ON_REQ_LEN = 6U;
+
+const uint8_t  SESSIONA_CREDITS_OFF_REQ[]   = { MARKER, 0x06U, 0x00U, 0x0BU, 0x01U, 0x00U };
+const uint16_t SESSIONA_CREDITS_OFF_REQ_LEN = 6U;
+
+const uint8_t  SESSIONA_CREDITS_REP[]   = { MARKER, 0x06U, 0x00U, 0x0BU, 0x01U };
+const uint16_t SESSIONA_CREDITS_REP_LEN = 5U;
+
+// Session 1 batch of two DMR/NXDN frames
+const uint8_t  SESSIONA_BATCH_REQ[]   = { MARKER, 0x1AU, 0x00U, 0x0AU, 0x01U, 0x02U, 0x09U, 0x00U,
+                                          0xA6U, 0xCBU, 0x80U, 0x27U, 0x20U, 0x4FU, 0x9BU, 0xCBU, 0xF3U,
+                                          0xA6U, 0xCBU, 0x80U, 0x27U, 0x20U, 0x4FU, 0x9BU, 0xCBU, 0xF3U };
+const uint16_t SESSIONA_BATCH_REQ_LEN = 26U;
+
+const uint8_t  SESSIONA_BATCH_REP[]   = { MARKER, 0x1CU, 0x00U, 0x0AU, 0x01U, 0x02U, 0x09U, 0x00U, 0x00U };
+const uint16_t SESSIONA_BATCH_REP_LEN = 9U;
+
+// Session 1 batch with no frames
+const uint8_t  SESSIONA_BATCH0_REQ[]   = { MARKER, 0x08U, 0x00U, 0x0AU, 0x01U, 0x00U, 0x09U, 0x00U };
+const uint16_t SESSIONA_BATCH0_REQ_LEN = 8U;
+
+const uint8_t  SESSIONA_NAK4[]   = { MARKER, 0x06U, 0x00U, 0x08U, 0x01U, 0x04U };
+const uint16_t SESSIONA_NAK4_LEN = 6U;
+
+// Session 2 batch of three short frames, returned unchanged
+const uint8_t  SESSIONB_BATCH_REQ[]   = { MARKER, 0x11U, 0x00U, 0x0AU, 0x02U, 0x03U, 0x03U, 0x00U,
+                                          0x01U, 0x02U, 0x03U, 0x04U, 0x05U, 0x06U, 0x07U, 0x08U, 0x09U };
+const uint16_t SESSIONB_BATCH_REQ_LEN = 17U;
+
+const uint8_t  SESSIONB_BATCH_REP[]   = { MARKER, 0x14U, 0x00U, 0x0AU, 0x02U, 0x03U, 0x03U, 0x00U,
+                                          0x00U, 0x01U, 0x02U, 0x03U, 0x00U, 0x04U, 0x05U, 0x06U, 0x00U, 0x07U, 0x08U, 0x09U };
+const uint16_t SESSIONB_BATCH_REP_LEN = 20U;
+
+// Session 1 DMR/NXDN to PCM Mode Set, used while the AMBE chip is still coming out of the reset for passthrough
+const uint8_t  SET_SESSIONA_PCM_REQ[]   = { MARKER, 0x07U, 0x00U, 0x06U, 0x01U, 0x02U, 0xFFU };
+const uint16_t SET_SESSIONA_PCM_REQ_LEN = 7U;
+
+// Both frames wait out the reset and time out in the batch
+const uint8_t  SESSIONA_BATCH_TIMEOUT_REP[]   = { MARKER, 0x0AU, 0x00U, 0x0AU, 0x01U, 0x02U, 0x00U, 0x00U, 0x04U, 0x04U };
+const uint16_t SESSIONA_BATCH_TIMEOUT_REP_LEN = 10U;
+
+// Session 1 batch of one DMR/NXDN frame, the PCM returned is not checked
+const uint8_t  SESSIONA_BATCH1_REQ[]   = { MARKER, 0x11U, 0x00U, 0x0AU, 0x01U, 0x01U, 0x09U, 0x00U,
+                                           0xA6U, 0xCBU, 0x80U, 0x27U, 0x20U, 0x4FU, 0x9BU, 0xCBU, 0xF3U };
+const uint16_t SESSIONA_BATCH1_REQ_LEN = 17U;
+
+const uint8_t  SESSIONA_BATCH1_REP[]   = { MARKER, 0x49U, 0x01U, 0x0AU, 0x01U, 0x01U, 0x40U, 0x01U, 0x00U };
+const uint16_t SESSIONA_BATCH1_REP_LEN = 9U;
+
+// Nothing from the timed out batch is left in the session, so all of its credits are free
+const uint8_t  SESSIONA_CREDITS_FULL_REP[]   = { MARKER, 0x06U, 0x00U, 0x0BU, 0x01U, 0x04U };
+const uint16_t SESSIONA_CREDITS_FULL_REP_LEN = 6U;
+
+// Session 1 IMBE fanned out to IMBE, decoded to PCM once and encoded again
+const uint8_t  SET_SESSIONA_FANOUT_REQ[]   = { MARKER, 0x08U, 0x00U, 0x0FU, 0x01U, 0x04U, 0x01U, 0x04U };
+const uint16_t SET_SESSIONA_FANOUT_REQ_LEN = 8U;
+
+const uint8_t  SESSIONA_FANOUT_DATA_REQ[]   = { MARKER, 0x10U, 0x00U, 0x09U, 0x01U, 0x08U, 0x71U, 0x6DU, 0x0BU, 0xABU, 0xC7U, 0xC6U, 0x49U, 0x38U, 0xDDU, 0x09U };
+const uint16_t SESSIONA_FANOUT_DATA_REQ_LEN = 16U;
+
+const uint8_t  SESSIONA_FANOUT_DATA_REP[]   = { MARKER, 0x11U, 0x00U, 0x10U, 0x01U, 0x04U };
+const uint16_t SESSIONA_FANOUT_DATA_REP_LEN = 6U;
+
+// Fan-out to the same mode twice
+const uint8_t  SET_SESSIONA_FANOUT2_REQ[]   = { MARKER, 0x09U, 0x00U, 0x0FU, 0x01U, 0x04U, 0x02U, 0x04U, 0x04U };
+const uint16_t SET_SESSIONA_FANOUT2_REQ_LEN = 9U;
+
+const uint8_t  SESSIONA_NAK2[]   = { MARKER, 0x06U, 0x00U, 0x08U, 0x01U, 0x02U };
+const uint16_t SESSIONA_NAK2_LEN = 6U;
+
+// Session 1 close
+const uint8_t  CLOSE_SESSIONA_REQ[]   = { MARKER, 0x07U, 0x00U, 0x06U, 0x01U, 0x00U, 0x00U };
+const uint16_t CLOSE_SESSIONA_REQ_LEN = 7U;
+
+const uint8_t  SESSIONA_NAK3[]   = { MARKER, 0x06U, 0x00U, 0x08U, 0x01U, 0x03U };
+const uint16_t SESSIONA_NAK3_LEN = 6U;
+
+// Session 2 close
+const uint8_t  CLOSE_SESSIONB_REQ[]   = { MARKER, 0x07U, 0x00U, 0x06U, 0x02U, 0x00U, 0x00U };
+const uint16_t CLOSE_SESSIONB_REQ_LEN = 7U;
+
+// Unknown session Mode Set
+const uint8_t  SET_SESSIONN_REQ[]   = { MARKER, 0x07U, 0x00U, 0x06U, 0x7FU, 0x02U, 0x02U };
+const uint16_t SET_SESSIONN_REQ_LEN = 7U;
+
+const uint8_t  SESSIONN_NAK2[]   = { MARKER, 0x06U, 0x00U, 0x08U, 0x7FU, 0x02U };
+const uint16_t SESSIONN_NAK2_LEN = 6U;
+
 /* Error Cases */
 
 // DMR to unknown Mode Set
@@ -523,6 +655,9 @@ int CTester::run()
         return 1;
     }
 
+    uint8_t sessions = (resultLen > 7U) ? result[7U] : 1U;
+    printf("Sessions: %u\n", sessions);
+
     printf("Software vocoders: ");
     bool hasALaw = (result[5U] & 0x01U) == 0x01U;
     if (hasALaw)
@@ -541,6 +676,11 @@ int CTester::run()
         printf("ACELP ");
     printf("\n");
 
+    // Take over the firmware debug output so that it can be checked at the end
+    ret2 = trace("Get Trace");
+    if (ret2 == RESULT::ERR)
+        return 1;
+
     printf("\nD-Star\n");
 
     if (hardware >= 0x01U) {
@@ -1049,6 +1189,113 @@ int CTester::run()
             return 1;
     }
 
+    if (sessions >= 3U) {
+        printf("\nSessions\n");
+
+        ret2 = test("Set Session 1 DMR/NXDN to DMR/NXDN", SET_SESSIONA_REQ, SET_SESSIONA_REQ_LEN, SESSIONA_ACK, SESSIONA_ACK_LEN);
+        if (ret2 == RESULT::ERR)
+            return 1;
+
+        ret2 = test("Set Session 2 PCM to PCM", SET_SESSIONB_REQ, SET_SESSIONB_REQ_LEN, SESSIONB_ACK, SESSIONB_ACK_LEN);
+        if (ret2 == RESULT::ERR)
+            return 1;
+
+        ret2 = test("Transcode Session 1 DMR/NXDN to DMR/NXDN", SESSIONA_DATA, SESSIONA_DATA_REQ_LEN, SESSIONA_DATA, SESSIONA_DATA_REP_LEN);
+        if (ret2 == RESULT::ERR)
+            return 1;
+
+        ret2 = test("Transcode Session 2 PCM to PCM", SESSIONB_DATA, SESSIONB_DATA_REQ_LEN, SESSIONB_DATA, SESSIONB_DATA_REP_LEN);
+        if (ret2 == RESULT::ERR)
+            return 1;
+
+        ret2 = test("Transcode Session 1 with sequence number", SESSIONA_DATA_EXT_REQ, SESSIONA_DATA_EXT_REQ_LEN, SESSIONA_DATA_EXT_REP, SESSIONA_DATA_EXT_REP_LEN);
+        if (ret2 == RESULT::ERR)
+            return 1;
+
+        ret2 = stats("Get Statistics");
+        if (ret2 == RESULT::ERR)
+            return 1;
+
+        ret2 = test("Enable credits on Session 1", SESSIONA_CREDITS_ON_REQ, SESSIONA_CREDITS_ON_REQ_LEN, SESSIONA_CREDITS_REP, SESSIONA_CREDITS_REP_LEN);
+        if (ret2 == RESULT::ERR)
+            return 1;
+
+        ret2 = test("Disable credits on Session 1", SESSIONA_CREDITS_OFF_REQ, SESSIONA_CREDITS_OFF_REQ_LEN, SESSIONA_CREDITS_REP, SESSIONA_CREDITS_REP_LEN);
+        if (ret2 == RESULT::ERR)
+            return 1;
+
+        ret2 = test("Batch Session 1 DMR/NXDN to DMR/NXDN", SESSIONA_BATCH_REQ, SESSIONA_BATCH_REQ_LEN, SESSIONA_BATCH_REP, SESSIONA_BATCH_REP_LEN);
+        if (ret2 == RESULT::ERR)
+            return 1;
+
+        ret2 = test("Batch Session 1 with no frames", SESSIONA_BATCH0_REQ, SESSIONA_BATCH0_REQ_LEN, SESSIONA_NAK4, SESSIONA_NAK4_LEN);
+        if (ret2 == RESULT::ERR)
+            return 1;
+
+        ret2 = test("Batch Session 2 PCM to PCM", SESSIONB_BATCH_REQ, SESSIONB_BATCH_REQ_LEN, SESSIONB_BATCH_REP, SESSIONB_BATCH_REP_LEN);
+        if (ret2 == RESULT::ERR)
+            return 1;
+
+        ret2 = test("Set Session 1 IMBE fan-out to IMBE", SET_SESSIONA_FANOUT_REQ, SET_SESSIONA_FANOUT_REQ_LEN, SESSIONA_ACK, SESSIONA_ACK_LEN);
+        if (ret2 == RESULT::ERR)
+            return 1;
+
+        ret2 = test("Transcode Session 1 IMBE fan-out", SESSIONA_FANOUT_DATA_REQ, SESSIONA_FANOUT_DATA_REQ_LEN, SESSIONA_FANOUT_DATA_REP, SESSIONA_FANOUT_DATA_REP_LEN);
+        if (ret2 == RESULT::ERR)
+            return 1;
+
+        ret2 = test("Set Session 1 fan-out with a repeated mode", SET_SESSIONA_FANOUT2_REQ, SET_SESSIONA_FANOUT2_REQ_LEN, SESSIONA_NAK2, SESSIONA_NAK2_LEN);
+        if (ret2 == RESULT::ERR)
+            return 1;
+
+        ret2 = test("Close Session 1", CLOSE_SESSIONA_REQ, CLOSE_SESSIONA_REQ_LEN, SESSIONA_ACK, SESSIONA_ACK_LEN);
+        if (ret2 == RESULT::ERR)
+            return 1;
+
+        ret2 = test("Transcode on closed Session 1", SESSIONA_DATA, SESSIONA_DATA_REQ_LEN, SESSIONA_NAK3, SESSIONA_NAK3_LEN);
+        if (ret2 == RESULT::ERR)
+            return 1;
+
+        ret2 = test("Close Session 2", CLOSE_SESSIONB_REQ, CLOSE_SESSIONB_REQ_LEN, SESSIONB_ACK, SESSIONB_ACK_LEN);
+        if (ret2 == RESULT::ERR)
+            return 1;
+
+        if (hardware >= 0x01U) {
+            // Passthrough resets the AMBE chip, the frames are held until it is ready and so time out
+            ret2 = test("Set Passthrough Mode", SET_MODEPA_REQ, SET_MODEPA_REQ_LEN, ACK, ACK_LEN);
+            if (ret2 == RESULT::ERR)
+                return 1;
+
+            ret2 = test("Set Session 1 DMR/NXDN to PCM", SET_SESSIONA_PCM_REQ, SET_SESSIONA_PCM_REQ_LEN, SESSIONA_ACK, SESSIONA_ACK_LEN);
+            if (ret2 == RESULT::ERR)
+                return 1;
+
+            ret2 = test("Batch Session 1 during an AMBE reset", SESSIONA_BATCH_REQ, SESSIONA_BATCH_REQ_LEN, SESSIONA_BATCH_TIMEOUT_REP, SESSIONA_BATCH_TIMEOUT_REP_LEN);
+            if (ret2 == RESULT::ERR)
+                return 1;
+
+            ret2 = test("Batch Session 1 after a timeout", SESSIONA_BATCH1_REQ, SESSIONA_BATCH1_REQ_LEN, SESSIONA_BATCH1_REP, SESSIONA_BATCH1_REP_LEN);
+            if (ret2 == RESULT::ERR)
+                return 1;
+
+            ret2 = test("Enable credits on Session 1", SESSIONA_CREDITS_ON_REQ, SESSIONA_CREDITS_ON_REQ_LEN, SESSIONA_CREDITS_FULL_REP, SESSIONA_CREDITS_FULL_REP_LEN);
+            if (ret2 == RESULT::ERR)
+                return 1;
+
+            ret2 = test("Disable credits on Session 1", SESSIONA_CREDITS_OFF_REQ, SESSIONA_CREDITS_OFF_REQ_LEN, SESSIONA_CREDITS_REP, SESSIONA_CREDITS_REP_LEN);
+            if (ret2 == RESULT::ERR)
+                return 1;
+
+            ret2 = test("Close Session 1", CLOSE_SESSIONA_REQ, CLOSE_SESSIONA_REQ_LEN, SESSIONA_ACK, SESSIONA_ACK_LEN);
+            if (ret2 == RESULT::ERR)
+                return 1;
+        }
+
+        ret2 = test("Set unknown Session", SET_SESSIONN_REQ, SET_SESSIONN_REQ_LEN, SESSIONN_NAK2, SESSIONN_NAK2_LEN);
+        if (ret2 == RESULT::ERR)
+            return 1;
+    }
+
     printf("\nError Cases\n");
 
     ret2 = test("Set Mode DMR to unknown", SET_MODEN_REQ, SET_MODEN_REQ_LEN, NAK2, NAK2_LEN);
@@ -1063,6 +1310,10 @@ int CTester::run()
     if (ret2 == RESULT::ERR)
         return 1;
 
+    ret2 = trace("Get Trace");
+    if (ret2 == RESULT::ERR)
+        return 1;
+
     printf("\nNo tests: %u, ok: %u (%.1f%%), failed: %u (%.1f%%)\n", m_count, m_ok, 100.0F * float(m_ok) / float(m_count), m_failed, 100.0F * float(m_failed) / float(m_count));
 
     return 0;
@@ -1126,6 +1377,91 @@ RESULT CTester::test(const char* title, const uint8_t* inData, uint16_t inLen, c
     return RESULT::PASS;
 }
 
+RESULT CTester::trace(const char* title)
+{
+    uint8_t buffer[400U];
+    uint16_t len = 0U;
+
+    RESULT ret = test(title, GET_TRACE_REQ, GET_TRACE_REQ_LEN, nullptr, 0U, buffer, &len);
+    if (ret != RESULT::PASS)
+        return ret;
+
+    if ((len < 6U) || (buffer[3U] != 0x0EU)) {
+        printf(", Failed\n");
+        dump("Read", buffer, len);
+        printf("\n");
+        m_failed++;
+        return RESULT::FAIL;
+    }
+
+    printf(", OK\n");
+    m_ok++;
+
+    decodeTrace(buffer, len);
+
+    return RESULT::PASS;
+}
+
+RESULT CTester::stats(const char* title)
+{
+    uint8_t buffer[400U];
+    uint16_t len = 0U;
+
+    RESULT ret = test(title, GET_STATS_REQ, GET_STATS_REQ_LEN, nullptr, 0U, buffer, &len);
+    if (ret != RESULT::PASS)
+        return ret;
+
+    uint16_t expected = 0U;
+    if (len > GET_STATS_CHANNELS_POS)
+        expected = GET_STATS_CHANNELS_POS + 1U + buffer[GET_STATS_CHANNELS_POS] * 8U;
+
+    if ((len != expected) || (buffer[3U] != 0x0DU) || (buffer[4U] != 0x03U)) {
+        printf(", Failed\n");
+        dump("Read", buffer, len);
+        printf("\n");
+        m_failed++;
+        return RESULT::FAIL;
+    }
+
+    printf(", OK\n");
+    m_ok++;
+
+    return RESULT::PASS;
+}
+
+void CTester::decodeTrace(const uint8_t* buffer, uint16_t length) const
+{
+    assert(buffer != nullptr);
+
+    uint16_t dropped = (buffer[4U] << 0) | (buffer[5U] << 8);
+    if (dropped > 0U)
+        printf("\t%u records dropped\n", dropped);
+
+    // Each record is a timestamp, the argument count, the arguments and the text
+    uint16_t pos = 6U;
+    while ((pos + 5U) < length) {
+        uint32_t time = (buffer[pos + 0U] << 0) | (buffer[pos + 1U] << 8) | (buffer[pos + 2U] << 16) | (buffer[pos + 3U] << 24);
+        uint8_t count = buffer[pos + 4U];
+        pos += 5U;
+
+        if ((pos + count * 2U) >= length)
+            break;
+
+        int16_t args[4U];
+        for (uint8_t i = 0U; i < count && i < 4U; i++, pos += 2U)
+            args[i] = int16_t((buffer[pos + 0U] << 0) | (buffer[pos + 1U] << 8));
+
+        const char* text = (const char*)(buffer + pos);
+        uint16_t textLen = ::strnlen(text, length - pos);
+        pos += textLen + 1U;
+
+        printf("\t%10u us: %.*s", time, int(textLen), text);
+        for (uint8_t i = 0U; i < count && i < 4U; i++)
+            printf(" %d", args[i]);
+        printf("\n");
+    }
+}
+
 void CTester::dump(const char* title, const uint8_t* buffer, uint16_t length) const
 {
     assert(title != nullptr);
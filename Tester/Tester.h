@@ -50,6 +50,9 @@ protected:
 	unsigned int  m_failed;
 
 	RESULT   test(const char* title, const uint8_t* inData, uint16_t inLen, const uint8_t* outData, uint16_t outLen, uint8_t* result = nullptr, uint16_t* resultLen = nullptr);
+	RESULT   trace(const char* title);
+	RESULT   stats(const char* title);
+	void     decodeTrace(const uint8_t* buffer, uint16_t length) const;
 	void     dump(const char* title, const uint8_t* buffer, uint16_t length) const;
 	uint16_t read(uint8_t* buffer, uint16_t timeout);
 };
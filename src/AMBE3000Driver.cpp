@@ -38,83 +38,113 @@ const uint8_t DVSI_PKT_CHANNEL2 = 0x42U;
 const uint16_t DVSI_PCM_SAMPLES = 160U;
 const uint16_t DVSI_PCM_BYTES   = DVSI_PCM_SAMPLES * sizeof(int16_t);
 
+// A chip replies well within two frame periods, any frames that it still owes after that have been lost
+const uint32_t DVSI_REPLY_TIMEOUT = 40U;
+
 CAMBE3000Driver::CAMBE3000Driver() :
-m_buffer0(),
-m_length0(0U),
-#if AMBE_TYPE == 2
-m_buffer1(),
-m_length1(0U),
-#endif
-m_utils()
+m_chip()
 {
 }
 
 void CAMBE3000Driver::startup()
 {
-  dvsi1.startup();
-  dvsi1.reset();
+  for (uint8_t n = 0U; n < AMBE3000_CHIPS; n++)
+    getDriver(n).startup();
 
-#if AMBE_TYPE == 2
-  dvsi2.startup();
-  dvsi2.reset();
-#endif
+  reset();
+}
+
+void CAMBE3000Driver::reset()
+{
+  // The chips come out of reset at their default rates and with nothing in flight
+  for (uint8_t n = 0U; n < AMBE3000_CHIPS; n++) {
+    AMBE3000_CHIP& chip = m_chip[n];
+
+    getDriver(n).reset();
+    chip.m_utils.reset();
+    chip.m_queue.reset();
+    chip.m_pending = 0U;
+    chip.m_stale   = 0U;
+    chip.m_rerate  = false;
+  }
 }
 
-void CAMBE3000Driver::init(uint8_t n, AMBE_MODE mode)
+uint8_t CAMBE3000Driver::init(uint8_t n, AMBE_MODE mode)
 {
+  // Anything still in the chip belongs to the previous mode
+  drain(n);
+
+  AMBE3000_CHIP& chip = m_chip[n];
+
+  // A session of the same mode on the chip can reuse its rate, and avoid waiting for the chip
+  if (chip.m_utils.hasRate(mode)) {
+    DEBUG2("AMBE3000 already at the rate, mode change skipped ", n);
+    return 0x00U;
+  }
+
   uint8_t buffer[100U];
-  uint16_t length = m_utils.createModeChange(mode, buffer);
+  uint16_t length = chip.m_utils.createModeChange(mode, buffer);
 
-#if AMBE_TYPE == 2
-  if (n == 0U) {
-    dvsi1.write(buffer, length);
-#if defined(HAS_LEDS)
-    leds.setLED1(true);
-#endif
-  } else {
-    dvsi2.write(buffer, length);
-#if defined(HAS_LEDS)
-    leds.setLED3(true);
-#endif
+  // The chip keeps its old rate, which is no longer known to match
+  if (!getDriver(n).write(buffer, length)) {
+    DEBUG2("AMBE3000 mode change could not be sent ", n);
+    chip.m_utils.reset();
+    return 0x05U;
   }
-#else
-  dvsi1.write(buffer, length);
+
 #if defined(HAS_LEDS)
-  leds.setLED1(true);
-#endif
+  setLED(n, true);
 #endif
+
+  // The chip answers the rate change after every frame sent before it, so those are all dropped
+  // until then without needing to be counted, including any whose replies have been lost
+  chip.m_stale  = 0U;
+  chip.m_rerate = true;
+  chip.m_timer  = millis();
+
+  return 0x00U;
 }
 
-void CAMBE3000Driver::process()
+void CAMBE3000Driver::service()
 {
-  process(0U, dvsi1, m_length0, m_buffer0);
-#if AMBE_TYPE == 2
-  process(1U, dvsi2, m_length1, m_buffer1);
-#endif
+  for (uint8_t n = 0U; n < AMBE3000_CHIPS; n++)
+    getDriver(n).service();
 }
 
-void CAMBE3000Driver::process(uint8_t n, CDVSIDriver& driver, uint16_t& mLength, uint8_t* mBuffer)
+void CAMBE3000Driver::process()
 {
-  uint8_t buffer[500U];
-  uint16_t length = driver.read(buffer);
-  if (length == 0U)
-    return;
+  uint8_t buffer[DVSI_MAX_PACKET_LENGTH];
 
+  // Take every packet that has arrived from each chip, so that replies do not back up in the UART buffers
+  for (uint8_t n = 0U; n < AMBE3000_CHIPS; n++) {
+    for (;;) {
+      uint16_t length = getDriver(n).read(buffer);
+      if (length == 0U)
+        break;
+
+      m_chip[n].m_timer = millis();
+
+      process(n, buffer, length);
+    }
+
+    expire(n);
+  }
+}
+
+void CAMBE3000Driver::process(uint8_t n, const uint8_t* buffer, uint16_t length)
+{
 #if defined(HAS_LEDS)
-#if AMBE_TYPE == 2
-  if (n == 0U)
-    leds.setLED1(false);
-  else
-    leds.setLED3(false);
-#else
-  leds.setLED1(false);
-#endif
+  setLED(n, false);
 #endif
 
+  AMBE3000_CHIP& chip = m_chip[n];
+
   uint16_t pos = 0U;
 
   switch (buffer[3U]) {
     case DVSI_TYPE_CONTROL:
+      chip.m_rerate = false;
+
       pos = 4U;
       while (pos < length) {
         switch (buffer[pos]) {
@@ -136,11 +166,28 @@ void CAMBE3000Driver::process(uint8_t n, CDVSIDriver& driver, uint16_t& mLength,
       break;
 
     case DVSI_TYPE_AMBE:
-      mLength = m_utils.extractAMBEFrame(buffer, mBuffer);
-      break;
-
     case DVSI_TYPE_AUDIO:
-      mLength = m_utils.extractPCMFrame(buffer, mBuffer);
+      // Frames written before the chip was last set up belong to the previous session
+      if (chip.m_rerate)
+        return;
+
+      if (chip.m_stale > 0U) {
+        chip.m_stale--;
+        return;
+      }
+
+      if (chip.m_pending > 0U)
+        chip.m_pending--;
+
+      if (chip.m_queue.isFull()) {
+        DEBUG2("AMBE3000 queue is full, frame discarded ", n);
+        return;
+      }
+
+      if (buffer[3U] == DVSI_TYPE_AMBE)
+        chip.m_queue.push(chip.m_utils.extractAMBEFrame(buffer, chip.m_queue.next()));
+      else
+        chip.m_queue.push(chip.m_utils.extractPCMFrame(buffer, chip.m_queue.next()));
       break;
 
     default:
@@ -151,154 +198,161 @@ void CAMBE3000Driver::process(uint8_t n, CDVSIDriver& driver, uint16_t& mLength,
 
 uint8_t CAMBE3000Driver::writeAMBE(uint8_t n, const uint8_t* ambe)
 {
-#if AMBE_TYPE == 2
-  if (n == 0U)
-    return writeAMBE(n, dvsi1, ambe);
-  else
-    return writeAMBE(n, dvsi2, ambe);
-#else
-  return writeAMBE(n, dvsi1, ambe);
-#endif
-}
-
-uint8_t CAMBE3000Driver::writeAMBE(uint8_t n, CDVSIDriver& driver, const uint8_t* ambe)
-{
-  // If the RTS pin is high, then the chip does not expect any more data to be sent through
-  if (!driver.ready()) {
-    DEBUG1("The AMBE3000 chip is not ready to receive any more data");
+  if (space(n) == 0U) {
+    DEBUG2("The AMBE3000 queue is full", n);
     return 0x05U;
   }
 
+  AMBE3000_CHIP& chip = m_chip[n];
+
   uint8_t out[50U];
-  uint16_t pos = m_utils.createAMBEFrame(ambe, out);
+  uint16_t pos = chip.m_utils.createAMBEFrame(ambe, out);
 
 #if defined(HAS_LEDS)
-#if AMBE_TYPE == 2
-  if (n == 0U)
-    leds.setLED1(true);
-  else
-    leds.setLED3(true);
-#else
-  leds.setLED1(true);
-#endif
+  setLED(n, true);
 #endif
 
-  driver.write(out, pos);
+  // Held in the driver while the RTS pin is high
+  if (!getDriver(n).write(out, pos))
+    return 0x05U;
+
+  chip.m_pending++;
+  chip.m_timer = millis();
+  stats.channelFrame(n);
 
   return 0x00U;
 }
 
 uint8_t CAMBE3000Driver::writePCM(uint8_t n, const uint8_t* pcm)
 {
-#if AMBE_TYPE == 2
-  if (n == 0U)
-    return writePCM(n, dvsi1, pcm);
-  else
-    return writePCM(n, dvsi2, pcm);
-#else
-  return writePCM(n, dvsi1, pcm);
-#endif
-}
-
-uint8_t CAMBE3000Driver::writePCM(uint8_t n, CDVSIDriver& driver, const uint8_t* pcm)
-{
-  // If the RTS pin is high, then the chip does not expect any more data to be sent through
-  if (!driver.ready()) {
-    DEBUG1("The AMBE3000 chip is not ready to receive any more data");
+  if (space(n) == 0U) {
+    DEBUG2("The AMBE3000 queue is full", n);
     return 0x05U;
   }
 
+  AMBE3000_CHIP& chip = m_chip[n];
+
   uint8_t out[400U];
-  uint16_t pos = m_utils.createPCMFrame(pcm, out);
+  uint16_t pos = chip.m_utils.createPCMFrame(pcm, out);
 
 #if defined(HAS_LEDS)
-#if AMBE_TYPE == 2
-  if (n == 0U)
-    leds.setLED1(true);
-  else
-    leds.setLED3(true);
-#else
-  leds.setLED1(true);
-#endif
+  setLED(n, true);
 #endif
 
-  driver.write(out, pos);
+  // Held in the driver while the RTS pin is high
+  if (!getDriver(n).write(out, pos))
+    return 0x05U;
+
+  chip.m_pending++;
+  chip.m_timer = millis();
+  stats.channelFrame(n);
 
   return 0x00U;
 }
 
 AD_STATE CAMBE3000Driver::readAMBE(uint8_t n, uint8_t* ambe)
 {
-#if AMBE_TYPE == 2
-  if (n == 0U)
-    return readAMBE(n, dvsi1, ambe, m_length0, m_buffer0);
-  else
-    return readAMBE(n, dvsi2, ambe, m_length1, m_buffer1);
-#else
-  return readAMBE(n, dvsi1, ambe, m_length0, m_buffer0);
-#endif
-}
+  CFrameQueue<DVSI_FRAME_LENGTH>& queue = m_chip[n].m_queue;
 
-AD_STATE CAMBE3000Driver::readAMBE(uint8_t n, CDVSIDriver& driver, uint8_t* ambe, uint16_t& mLength, const uint8_t* mBuffer)
-{
-  switch (mLength) {
+  switch (queue.length()) {
     case 0U:
       return AD_STATE::NO_DATA;
 
     case DVSI_PCM_BYTES:
-      mLength = 0U;
+      queue.discard();
       return AD_STATE::WRONG_TYPE;
 
     default:
-      ::memcpy(ambe, mBuffer, mLength);
-      mLength = 0U;
+      queue.pop(ambe);
       return AD_STATE::DATA;
   }
 }
 
 AD_STATE CAMBE3000Driver::readPCM(uint8_t n, uint8_t* pcm)
 {
-#if AMBE_TYPE == 2
-  if (n == 0U)
-    return readPCM(n, dvsi1, pcm, m_length0, m_buffer0);
-  else
-    return readPCM(n, dvsi2, pcm, m_length1, m_buffer1);
-#else
-  return readPCM(n, dvsi1, pcm, m_length0, m_buffer0);
-#endif
-}
+  CFrameQueue<DVSI_FRAME_LENGTH>& queue = m_chip[n].m_queue;
 
-AD_STATE CAMBE3000Driver::readPCM(uint8_t n, CDVSIDriver& driver, uint8_t* pcm, uint16_t& mLength, const uint8_t* mBuffer)
-{
-  switch (mLength) {
+  switch (queue.length()) {
     case 0U:
       return AD_STATE::NO_DATA;
 
     case DVSI_PCM_BYTES:
-      ::memcpy(pcm, mBuffer, DVSI_PCM_BYTES);
-      mLength = 0U;
+      queue.pop(pcm);
       return AD_STATE::DATA;
 
     default:
-      mLength = 0U;
+      queue.discard();
       return AD_STATE::WRONG_TYPE;
   }
 }
 
+uint8_t CAMBE3000Driver::space(uint8_t n) const
+{
+  const AMBE3000_CHIP& chip = m_chip[n];
+
+  // Frames waiting to be sent or still inside the chip will need room in the queue when they come back
+  uint8_t used = chip.m_pending + chip.m_queue.count();
+  if (used >= FRAME_QUEUE_DEPTH)
+    return 0U;
+
+  return FRAME_QUEUE_DEPTH - used;
+}
+
 void CAMBE3000Driver::drain(uint8_t n)
 {
-#if AMBE_TYPE == 2
-  switch (n) {
-    case 0U:
-      m_length0 = 0U;
-      break;
-    default:
-      m_length1 = 0U;
-      break;
+  AMBE3000_CHIP& chip = m_chip[n];
+
+  chip.m_queue.reset();
+
+  // The chip works in order, so the replies still to come are dropped as they arrive
+  chip.m_stale  += chip.m_pending;
+  chip.m_pending = 0U;
+}
+
+void CAMBE3000Driver::expire(uint8_t n)
+{
+  AMBE3000_CHIP& chip = m_chip[n];
+
+  // Nothing can come back while the chip is resetting or its packets are held
+  if (getDriver(n).isBusy()) {
+    chip.m_timer = millis();
+    return;
   }
+
+  if ((millis() - chip.m_timer) <= DVSI_REPLY_TIMEOUT)
+    return;
+
+  // The replies are not coming, so stop waiting for them rather than dropping the next ones as stale
+  if ((chip.m_pending > 0U) || (chip.m_stale > 0U) || chip.m_rerate) {
+    DEBUG2("AMBE3000 replies lost on chip ", n);
+    chip.m_pending = 0U;
+    chip.m_stale   = 0U;
+    chip.m_rerate  = false;
+  }
+}
+
+CDVSIDriver& CAMBE3000Driver::getDriver(uint8_t n)
+{
+#if AMBE_TYPE == 2
+  if (n == 1U)
+    return dvsi2;
+#endif
+
+  return dvsi1;
+}
+
+#if defined(HAS_LEDS)
+void CAMBE3000Driver::setLED(uint8_t n, bool on)
+{
+#if AMBE_TYPE == 2
+  if (n == 0U)
+    leds.setLED1(on);
+  else
+    leds.setLED3(on);
 #else
-  m_length0 = 0U;
+  leds.setLED1(on);
 #endif
 }
+#endif
 
 #endif
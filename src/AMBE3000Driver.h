@@ -24,26 +24,52 @@
 #if AMBE_TYPE == 1 || AMBE_TYPE == 2
 
 #include "AMBE3000Utils.h"
+#include "FrameQueue.h"
 #include "DVSIDriver.h"
 
 #include <cstdint>
 
+const uint16_t DVSI_FRAME_LENGTH = 400U;
+
 enum class AD_STATE {
   NO_DATA,
   WRONG_TYPE,
   DATA
 };
 
+#if AMBE_TYPE == 2
+const uint8_t AMBE3000_CHIPS = 2U;
+#else
+const uint8_t AMBE3000_CHIPS = 1U;
+#endif
+
+// What the driver keeps for each chip
+struct AMBE3000_CHIP {
+  CFrameQueue<DVSI_FRAME_LENGTH> m_queue;
+  uint8_t                        m_pending;
+  uint8_t                        m_stale;
+  bool                           m_rerate;    // Waiting for the chip to answer a rate change, the frames before that belong to the previous mode
+  uint32_t                       m_timer;     // When the chip was last written to or replied
+  CAMBE3000Utils                 m_utils;     // Each chip is set to a rate of its own, so each has its own frame sizes
+};
+
 class CAMBE3000Driver {
   public:
     CAMBE3000Driver();
 
     void startup();
 
-    void init(uint8_t n, AMBE_MODE mode);
+    // Resets the chips, each one then needs its rate setting again
+    void reset();
+
+    // Only sends the rate to the chip when it is not already set to it
+    uint8_t init(uint8_t n, AMBE_MODE mode);
 
     void process();
 
+    // Moves any chip reset on and sends held packets, needed in every operating mode
+    void service();
+
     uint8_t writeAMBE(uint8_t n, const uint8_t* ambe);
 
     uint8_t writePCM(uint8_t n, const uint8_t* pcm);
@@ -52,24 +78,23 @@ class CAMBE3000Driver {
 
     AD_STATE readPCM(uint8_t n, uint8_t* pcm);
 
+    // The number of frames that can still be written to a chip
+    uint8_t space(uint8_t n) const;
+
     void drain(uint8_t n);
 
   private:
-    uint8_t        m_buffer0[400U];
-    uint16_t       m_length0;
-#if AMBE_TYPE == 2
-    uint8_t        m_buffer1[400U];
-    uint16_t       m_length1;
-#endif
-    CAMBE3000Utils m_utils;
+    AMBE3000_CHIP m_chip[AMBE3000_CHIPS];
+
+    void     process(uint8_t n, const uint8_t* buffer, uint16_t length);
 
-    void     process(uint8_t n, CDVSIDriver& driver, uint16_t& mLength, uint8_t* mBuffer);
+    void     expire(uint8_t n);
 
-    uint8_t  writeAMBE(uint8_t n, CDVSIDriver& driver, const uint8_t* ambe);
-    uint8_t  writePCM(uint8_t n, CDVSIDriver& driver, const uint8_t* pcm);
+    static CDVSIDriver& getDriver(uint8_t n);
 
-    AD_STATE readAMBE(uint8_t n, CDVSIDriver& driver, uint8_t* ambe, uint16_t& mLength, const uint8_t* mBuffer);
-    AD_STATE readPCM(uint8_t n, CDVSIDriver& driver, uint8_t* pcm, uint16_t& mLength, const uint8_t* mBuffer);
+#if defined(HAS_LEDS)
+    static void setLED(uint8_t n, bool on);
+#endif
 };
 
 #endif
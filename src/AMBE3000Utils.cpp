@@ -105,6 +105,18 @@ uint16_t CAMBE3000Utils::createModeChange(AMBE_MODE mode, uint8_t* buffer)
   return length;
 }
 
+bool CAMBE3000Utils::hasRate(AMBE_MODE mode) const
+{
+  const uint8_t* rate = getRate(mode);
+
+  return (rate != nullptr) && (rate == getRate(m_mode));
+}
+
+void CAMBE3000Utils::reset()
+{
+  m_mode = AMBE_MODE::NONE;
+}
+
 uint16_t CAMBE3000Utils::createAMBEFrame(const uint8_t* buffer, uint8_t* out) const
 {
   uint16_t pos = 0U;
@@ -169,4 +181,22 @@ void CAMBE3000Utils::swapBytes(uint8_t* out, const uint8_t* in, uint16_t length)
   }
 }
 
+const uint8_t* CAMBE3000Utils::getRate(AMBE_MODE mode)
+{
+  // The two directions of a mode share the rate, the packet identifies it
+  switch (mode) {
+    case AMBE_MODE::DSTAR_TO_PCM:
+    case AMBE_MODE::PCM_TO_DSTAR:
+      return DVSI_PKT_DSTAR_FEC;
+    case AMBE_MODE::DMR_NXDN_TO_PCM:
+    case AMBE_MODE::PCM_TO_DMR_NXDN:
+      return DVSI_PKT_MODE33;
+    case AMBE_MODE::YSFDN_TO_PCM:
+    case AMBE_MODE::PCM_TO_YSFDN:
+      return DVSI_PKT_MODE34;
+    default:
+      return nullptr;
+  }
+}
+
 #endif
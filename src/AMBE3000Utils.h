@@ -40,6 +40,12 @@ class CAMBE3000Utils {
     CAMBE3000Utils();
 
     uint16_t createModeChange(AMBE_MODE mode, uint8_t* buffer);
+
+    // True when the chip is already set to the rate that the mode needs
+    bool     hasRate(AMBE_MODE mode) const;
+
+    // After a chip reset the rate is not known
+    void     reset();
     uint16_t createAMBEFrame(const uint8_t* buffer, uint8_t* out) const;
     uint16_t createPCMFrame(const uint8_t* buffer, uint8_t* out) const;
 
@@ -52,6 +58,8 @@ class CAMBE3000Utils {
     uint8_t   m_bitsLen;
 
     void swapBytes(uint8_t* out, const uint8_t* in, uint16_t length) const;
+
+    static const uint8_t* getRate(AMBE_MODE mode);
 };
 
 #endif
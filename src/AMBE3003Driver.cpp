@@ -37,52 +37,122 @@ const uint8_t DVSI_PKT_RATEP    = 0x0AU;
 const uint16_t DVSI_PCM_SAMPLES = 160U;
 const uint16_t DVSI_PCM_BYTES   = DVSI_PCM_SAMPLES * sizeof(int16_t);
 
+// A chip replies well within two frame periods, any frames that it still owes after that have been lost
+const uint32_t DVSI_REPLY_TIMEOUT = 40U;
+
 CAMBE3003Driver::CAMBE3003Driver() :
-m_buffer0(),
-m_buffer1(),
-m_buffer2(),
-m_length0(0U),
-m_length1(0U),
-m_length2(0U),
-m_utils()
+m_queue(),
+m_pending(),
+m_stale(),
+m_rerate(),
+m_utils(),
+m_timer()
 {
 }
 
 void CAMBE3003Driver::startup()
 {
-  dvsi.startup();
-  dvsi.reset();
+  for (uint8_t chip = 0U; chip < AMBE3003_CHIPS; chip++)
+    dvsi[chip].startup();
+
+  reset();
+}
+
+void CAMBE3003Driver::reset()
+{
+  // The chips come out of reset at their default rates and with nothing in flight
+  for (uint8_t chip = 0U; chip < AMBE3003_CHIPS; chip++) {
+    dvsi[chip].reset();
+    m_utils[chip].reset();
+  }
+
+  for (uint8_t n = 0U; n < AMBE3003_POOL_CHANNELS; n++) {
+    m_queue[n].reset();
+    m_pending[n] = 0U;
+    m_stale[n]   = 0U;
+    m_rerate[n]  = false;
+  }
 }
 
-void CAMBE3003Driver::init(uint8_t n, AMBE_MODE mode)
+uint8_t CAMBE3003Driver::init(uint8_t n, AMBE_MODE mode)
 {
+  // Anything still in the channel belongs to the previous mode
+  drain(n);
+
+  uint8_t chip = n / AMBE3003_CHANNELS;
+
+  // A session of the same mode on the channel can reuse its rate, and avoid waiting for the chip
+  if (m_utils[chip].hasRate(n % AMBE3003_CHANNELS, mode)) {
+    DEBUG2("AMBE3003 channel already at the rate, mode change skipped ", n);
+    return 0x00U;
+  }
+
   uint8_t buffer[100U];
-  uint16_t length = m_utils.createModeChange(n, mode, buffer);
+  uint16_t length = m_utils[chip].createModeChange(n % AMBE3003_CHANNELS, mode, buffer);
+
+  // The channel keeps its old rate, which is no longer known to match, forgetting the others only costs them a rate change
+  if (!dvsi[chip].write(buffer, length)) {
+    DEBUG2("AMBE3003 mode change could not be sent ", n);
+    m_utils[chip].reset();
+    return 0x05U;
+  }
 
 #if defined(HAS_LEDS)
   leds.setLED1(true);
 #endif
 
-  dvsi.write(buffer, length);
+  // The chip answers the rate change after every frame sent before it, so those are all dropped
+  // until then without needing to be counted, including any whose replies have been lost
+  m_stale[n]    = 0U;
+  m_rerate[n]   = true;
+  m_timer[chip] = millis();
+
+  return 0x00U;
+}
+
+void CAMBE3003Driver::service()
+{
+  for (uint8_t chip = 0U; chip < AMBE3003_CHIPS; chip++)
+    dvsi[chip].service();
 }
 
 void CAMBE3003Driver::process()
 {
-  uint8_t buffer[500U];
-  uint16_t length = dvsi.read(buffer);
-  if (length == 0U)
-    return;
+  uint8_t buffer[DVSI_MAX_PACKET_LENGTH];
+
+  // Take every packet that has arrived from each chip, so that replies do not back up in the UART buffers
+  for (uint8_t chip = 0U; chip < AMBE3003_CHIPS; chip++) {
+    for (;;) {
+      uint16_t length = dvsi[chip].read(buffer);
+      if (length == 0U)
+        break;
+
+      process(chip, buffer, length);
+    }
+
+    expire(chip);
+  }
+}
 
+void CAMBE3003Driver::process(uint8_t chip, const uint8_t* buffer, uint16_t length)
+{
 #if defined(HAS_LEDS)
   leds.setLED1(false);
 #endif
 
   uint16_t pos = 0U;
 
-  uint8_t n = buffer[4U] - DVSI_CHANNEL_BASE;
+  // The channel on the chip, and its place in the pool
+  uint8_t channel = buffer[4U] - DVSI_CHANNEL_BASE;
+  uint8_t n       = (chip * AMBE3003_CHANNELS) + channel;
+
+  m_timer[chip] = millis();
 
   switch (buffer[3U]) {
     case DVSI_TYPE_CONTROL:
+      if (channel < AMBE3003_CHANNELS)
+        m_rerate[n] = false;
+
       pos = 6U;
       while (pos < length) {
         switch (buffer[pos]) {
@@ -104,31 +174,33 @@ void CAMBE3003Driver::process()
       break;
 
     case DVSI_TYPE_AMBE:
-      switch (n) {
-        case 0U:
-          m_length0 = m_utils.extractAMBEFrame(buffer, m_buffer0);
-          break;
-        case 1U:
-          m_length1 = m_utils.extractAMBEFrame(buffer, m_buffer1);
-          break;
-        default:
-          m_length2 = m_utils.extractAMBEFrame(buffer, m_buffer2);
-          break;
+    case DVSI_TYPE_AUDIO:
+      if (channel >= AMBE3003_CHANNELS) {
+        DEBUG2("Invalid AMBE3003 channel from the AMBE chip ", channel);
+        return;
       }
-      break;
 
-    case DVSI_TYPE_AUDIO:
-      switch (n) {
-        case 0U:
-          m_length0 = m_utils.extractPCMFrame(buffer, m_buffer0);
-          break;
-        case 1U:
-          m_length1 = m_utils.extractPCMFrame(buffer, m_buffer1);
-          break;
-        default:
-          m_length2 = m_utils.extractPCMFrame(buffer, m_buffer2);
-          break;
+      // Frames written before the channel was last set up belong to the previous session
+      if (m_rerate[n])
+        return;
+
+      if (m_stale[n] > 0U) {
+        m_stale[n]--;
+        return;
+      }
+
+      if (m_pending[n] > 0U)
+        m_pending[n]--;
+
+      if (m_queue[n].isFull()) {
+        DEBUG2("AMBE3003 channel queue is full, frame discarded ", n);
+        return;
       }
+
+      if (buffer[3U] == DVSI_TYPE_AMBE)
+        m_queue[n].push(m_utils[chip].extractAMBEFrame(channel, buffer, m_queue[n].next()));
+      else
+        m_queue[n].push(m_utils[chip].extractPCMFrame(channel, buffer, m_queue[n].next()));
       break;
 
     default:
@@ -139,162 +211,134 @@ void CAMBE3003Driver::process()
 
 uint8_t CAMBE3003Driver::writeAMBE(uint8_t n, const uint8_t* ambe)
 {
-  // If the RTS pin is high, then the chip does not expect any more data to be sent through
-  if (!dvsi.ready()) {
-    DEBUG1("The AMBE3003 chip is not ready to receive any more data");
+  if (space(n) == 0U) {
+    DEBUG2("The AMBE3003 channel queue is full", n);
     return 0x05U;
   }
 
   uint8_t out[50U];
-  uint16_t pos = m_utils.createAMBEFrame(n, ambe, out);
+  uint8_t chip = n / AMBE3003_CHANNELS;
+
+  uint16_t pos = m_utils[chip].createAMBEFrame(n % AMBE3003_CHANNELS, ambe, out);
 
 #if defined(HAS_LEDS)
   leds.setLED1(true);
 #endif
 
-  dvsi.write(out, pos);
+  // Held in the driver while the RTS pin is high
+  if (!dvsi[chip].write(out, pos))
+    return 0x05U;
+
+  m_pending[n]++;
+  m_timer[chip] = millis();
+  stats.channelFrame(n);
 
   return 0x00U;
 }
 
 uint8_t CAMBE3003Driver::writePCM(uint8_t n, const uint8_t* pcm)
 {
-  // If the RTS pin is high, then the chip does not expect any more data to be sent through
-  if (!dvsi.ready()) {
-    DEBUG1("The AMBE3003 chip is not ready to receive any more data");
+  if (space(n) == 0U) {
+    DEBUG2("The AMBE3003 channel queue is full", n);
     return 0x05U;
   }
 
   uint8_t out[400U];
-  uint16_t pos = m_utils.createPCMFrame(n, pcm, out);
+  uint8_t chip = n / AMBE3003_CHANNELS;
+
+  uint16_t pos = m_utils[chip].createPCMFrame(n % AMBE3003_CHANNELS, pcm, out);
 
 #if defined(HAS_LEDS)
   leds.setLED1(true);
 #endif
 
-  dvsi.write(out, pos);
+  // Held in the driver while the RTS pin is high
+  if (!dvsi[chip].write(out, pos))
+    return 0x05U;
+
+  m_pending[n]++;
+  m_timer[chip] = millis();
+  stats.channelFrame(n);
 
   return 0x00U;
 }
 
 AD_STATE CAMBE3003Driver::readAMBE(uint8_t n, uint8_t* ambe)
 {
-  switch (n) {
-    case 0U:
-      switch (m_length0) {
-        case 0U:
-          return AD_STATE::NO_DATA;
-
-        case DVSI_PCM_BYTES:
-          m_length0 = 0U;
-          return AD_STATE::WRONG_TYPE;
-
-        default:
-          ::memcpy(ambe, m_buffer0, m_length0);
-          m_length0 = 0U;
-          return AD_STATE::DATA;
-      }
-      break;
-
-    case 1U:
-      switch (m_length1) {
-        case 0U:
-          return AD_STATE::NO_DATA;
+  CFrameQueue<DVSI_FRAME_LENGTH>& queue = m_queue[n];
 
-        case DVSI_PCM_BYTES:
-          m_length1 = 0U;
-          return AD_STATE::WRONG_TYPE;
+  switch (queue.length()) {
+    case 0U:
+      return AD_STATE::NO_DATA;
 
-        default:
-          ::memcpy(ambe, m_buffer1, m_length1);
-          m_length1 = 0U;
-          return AD_STATE::DATA;
-      }
-      break;
+    case DVSI_PCM_BYTES:
+      queue.discard();
+      return AD_STATE::WRONG_TYPE;
 
     default:
-      switch (m_length2) {
-        case 0U:
-          return AD_STATE::NO_DATA;
-
-        case DVSI_PCM_BYTES:
-          m_length2 = 0U;
-          return AD_STATE::WRONG_TYPE;
-
-        default:
-          ::memcpy(ambe, m_buffer2, m_length2);
-          m_length2 = 0U;
-          return AD_STATE::DATA;
-      }
-      break;
+      queue.pop(ambe);
+      return AD_STATE::DATA;
   }
 }
 
 AD_STATE CAMBE3003Driver::readPCM(uint8_t n, uint8_t* pcm)
 {
-  switch (n) {
-    case 0U:
-      switch (m_length0) {
-        case 0U:
-          return AD_STATE::NO_DATA;
-
-        case DVSI_PCM_BYTES:
-          ::memcpy(pcm, m_buffer0, DVSI_PCM_BYTES);
-          m_length0 = 0U;
-          return AD_STATE::DATA;
-
-        default:
-          m_length0 = 0U;
-          return AD_STATE::WRONG_TYPE;
-      }
-      break;
+  CFrameQueue<DVSI_FRAME_LENGTH>& queue = m_queue[n];
 
-    case 1U:
-      switch (m_length1) {
-        case 0U:
-          return AD_STATE::NO_DATA;
+  switch (queue.length()) {
+    case 0U:
+      return AD_STATE::NO_DATA;
 
-        case DVSI_PCM_BYTES:
-          ::memcpy(pcm, m_buffer1, DVSI_PCM_BYTES);
-          m_length1 = 0U;
-          return AD_STATE::DATA;
-
-        default:
-          m_length1 = 0U;
-          return AD_STATE::WRONG_TYPE;
-      }
-      break;
+    case DVSI_PCM_BYTES:
+      queue.pop(pcm);
+      return AD_STATE::DATA;
 
     default:
-      switch (m_length2) {
-        case 0U:
-          return AD_STATE::NO_DATA;
-
-        case DVSI_PCM_BYTES:
-          ::memcpy(pcm, m_buffer2, DVSI_PCM_BYTES);
-          m_length2 = 0U;
-          return AD_STATE::DATA;
-
-        default:
-          m_length2 = 0U;
-          return AD_STATE::WRONG_TYPE;
-      }
-      break;
+      queue.discard();
+      return AD_STATE::WRONG_TYPE;
   }
 }
 
+uint8_t CAMBE3003Driver::space(uint8_t n) const
+{
+  // Frames waiting to be sent or still inside the chip will need room in the queue when they come back
+  uint8_t used = m_pending[n] + m_queue[n].count();
+  if (used >= FRAME_QUEUE_DEPTH)
+    return 0U;
+
+  return FRAME_QUEUE_DEPTH - used;
+}
+
 void CAMBE3003Driver::drain(uint8_t n)
 {
-  switch (n) {
-    case 0U:
-      m_length0 = 0U;
-      break;
-    case 1U:
-      m_length1 = 0U;
-      break;
-    default:
-      m_length2 = 0U;
-      break;
+  m_queue[n].reset();
+
+  // The chip works in order, so the replies still to come are dropped as they arrive
+  m_stale[n]  += m_pending[n];
+  m_pending[n] = 0U;
+}
+
+void CAMBE3003Driver::expire(uint8_t chip)
+{
+  // Nothing can come back while the chip is resetting or its packets are held
+  if (dvsi[chip].isBusy()) {
+    m_timer[chip] = millis();
+    return;
+  }
+
+  if ((millis() - m_timer[chip]) <= DVSI_REPLY_TIMEOUT)
+    return;
+
+  // The replies are not coming, so stop waiting for them rather than dropping the next ones as stale
+  for (uint8_t channel = 0U; channel < AMBE3003_CHANNELS; channel++) {
+    uint8_t n = (chip * AMBE3003_CHANNELS) + channel;
+
+    if ((m_pending[n] > 0U) || (m_stale[n] > 0U) || m_rerate[n]) {
+      DEBUG2("AMBE3003 replies lost on channel ", n);
+      m_pending[n] = 0U;
+      m_stale[n]   = 0U;
+      m_rerate[n]  = false;
+    }
   }
 }
 
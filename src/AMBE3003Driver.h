@@ -24,9 +24,12 @@
 #if AMBE_TYPE == 3
 
 #include "AMBE3003Utils.h"
+#include "FrameQueue.h"
 
 #include <cstdint>
 
+const uint16_t DVSI_FRAME_LENGTH = 400U;
+
 enum class AD_STATE {
   NO_DATA,
   WRONG_TYPE,
@@ -39,10 +42,17 @@ class CAMBE3003Driver {
 
     void startup();
 
-    void init(uint8_t n, AMBE_MODE mode);
+    // Resets the chips, every channel then needs its rate setting again
+    void reset();
+
+    // Only sends the rate to the chip when the channel is not already set to it
+    uint8_t init(uint8_t n, AMBE_MODE mode);
 
     void process();
 
+    // Moves any chip reset on and sends held packets, needed in every operating mode
+    void service();
+
     uint8_t writeAMBE(uint8_t n, const uint8_t* ambe);
 
     uint8_t writePCM(uint8_t n, const uint8_t* pcm);
@@ -51,16 +61,24 @@ class CAMBE3003Driver {
 
     AD_STATE readPCM(uint8_t n, uint8_t* pcm);
 
+    // The number of frames that can still be written to a channel
+    uint8_t space(uint8_t n) const;
+
     void drain(uint8_t n);
 
   private:
-    uint8_t        m_buffer0[400U];
-    uint8_t        m_buffer1[400U];
-    uint8_t        m_buffer2[400U];
-    uint16_t       m_length0;
-    uint16_t       m_length1;
-    uint16_t       m_length2;
-    CAMBE3003Utils m_utils;
+    // The channels are numbered across the pool of chips, the utils of each chip number its own from zero
+    CFrameQueue<DVSI_FRAME_LENGTH> m_queue[AMBE3003_POOL_CHANNELS];
+    uint8_t                        m_pending[AMBE3003_POOL_CHANNELS];
+    uint8_t                        m_stale[AMBE3003_POOL_CHANNELS];
+    // Waiting for the chip to answer a rate change, the frames before that belong to the previous mode
+    bool                           m_rerate[AMBE3003_POOL_CHANNELS];
+    CAMBE3003Utils                 m_utils[AMBE3003_CHIPS];
+    // When each chip was last written to or replied
+    uint32_t                       m_timer[AMBE3003_CHIPS];
+
+    void process(uint8_t chip, const uint8_t* buffer, uint16_t length);
+    void expire(uint8_t chip);
 };
 
 #endif
@@ -59,10 +59,12 @@ const uint16_t DVSI_PCM_SAMPLES = 160U;
 const uint16_t DVSI_PCM_BYTES   = DVSI_PCM_SAMPLES * sizeof(int16_t);
 
 CAMBE3003Utils::CAMBE3003Utils() :
-m_mode(AMBE_MODE::NONE),
-m_bytesLen(0U),
-m_bitsLen(0U)
+m_mode(),
+m_bytesLen(),
+m_bitsLen()
 {
+  for (uint8_t i = 0U; i < AMBE3003_CHANNELS; i++)
+    m_mode[i] = AMBE_MODE::NONE;
 }
 
 uint16_t CAMBE3003Utils::createModeChange(uint8_t n, AMBE_MODE mode, uint8_t* buffer)
@@ -81,22 +83,22 @@ uint16_t CAMBE3003Utils::createModeChange(uint8_t n, AMBE_MODE mode, uint8_t* bu
     case AMBE_MODE::PCM_TO_DSTAR:
       ::memcpy(buffer + length, DVSI_PKT_DSTAR_FEC, DVSI_PKT_DSTAR_FEC_LEN);
       length += DVSI_PKT_DSTAR_FEC_LEN;
-      m_bytesLen = DVSI_PKT_DSTAR_FEC_BYTES_LEN;
-      m_bitsLen  = DVSI_PKT_DSTAR_FEC_BITS_LEN;
+      m_bytesLen[n] = DVSI_PKT_DSTAR_FEC_BYTES_LEN;
+      m_bitsLen[n]  = DVSI_PKT_DSTAR_FEC_BITS_LEN;
       break;
     case AMBE_MODE::DMR_NXDN_TO_PCM:
     case AMBE_MODE::PCM_TO_DMR_NXDN:
       ::memcpy(buffer + length, DVSI_PKT_MODE33, DVSI_PKT_MODE33_LEN);
       length += DVSI_PKT_MODE33_LEN;
-      m_bytesLen = DVSI_PKT_MODE33_BYTES_LEN;
-      m_bitsLen  = DVSI_PKT_MODE33_BITS_LEN;
+      m_bytesLen[n] = DVSI_PKT_MODE33_BYTES_LEN;
+      m_bitsLen[n]  = DVSI_PKT_MODE33_BITS_LEN;
       break;
     case AMBE_MODE::YSFDN_TO_PCM:
     case AMBE_MODE::PCM_TO_YSFDN:
       ::memcpy(buffer + length, DVSI_PKT_MODE34, DVSI_PKT_MODE34_LEN);
       length += DVSI_PKT_MODE34_LEN;
-      m_bytesLen = DVSI_PKT_MODE34_BYTES_LEN;
-      m_bitsLen  = DVSI_PKT_MODE34_BITS_LEN;
+      m_bytesLen[n] = DVSI_PKT_MODE34_BYTES_LEN;
+      m_bitsLen[n]  = DVSI_PKT_MODE34_BITS_LEN;
       break;
     default:
       return 0U;
@@ -104,11 +106,24 @@ uint16_t CAMBE3003Utils::createModeChange(uint8_t n, AMBE_MODE mode, uint8_t* bu
 
   buffer[2U] = uint8_t(length - 4U);
 
-  m_mode = mode;
+  m_mode[n] = mode;
 
   return length;
 }
 
+bool CAMBE3003Utils::hasRate(uint8_t n, AMBE_MODE mode) const
+{
+  const uint8_t* rate = getRate(mode);
+
+  return (rate != nullptr) && (rate == getRate(m_mode[n]));
+}
+
+void CAMBE3003Utils::reset()
+{
+  for (uint8_t i = 0U; i < AMBE3003_CHANNELS; i++)
+    m_mode[i] = AMBE_MODE::NONE;
+}
+
 uint16_t CAMBE3003Utils::createAMBEFrame(uint8_t n, const uint8_t* buffer, uint8_t* out) const
 {
   uint16_t pos = 0U;
@@ -121,10 +136,10 @@ uint16_t CAMBE3003Utils::createAMBEFrame(uint8_t n, const uint8_t* buffer, uint8
   out[pos++] = DVSI_CHANNEL_BASE + n;
 
   out[pos++] = 0x01U;
-  out[pos++] = m_bitsLen;
+  out[pos++] = m_bitsLen[n];
 
-  ::memcpy(out + pos, buffer, m_bytesLen);
-  pos += m_bytesLen;
+  ::memcpy(out + pos, buffer, m_bytesLen[n]);
+  pos += m_bytesLen[n];
 
   out[1U] = (pos - 4U) / 256U;
   out[2U] = (pos - 4U) % 256U;
@@ -155,14 +170,14 @@ uint16_t CAMBE3003Utils::createPCMFrame(uint8_t n, const uint8_t* buffer, uint8_
   return pos;
 }
 
-uint16_t CAMBE3003Utils::extractAMBEFrame(const uint8_t* frame, uint8_t* data) const
+uint16_t CAMBE3003Utils::extractAMBEFrame(uint8_t n, const uint8_t* frame, uint8_t* data) const
 {
-  ::memcpy(data, frame + 5U + 1U + 1U, m_bytesLen);
+  ::memcpy(data, frame + 5U + 1U + 1U, m_bytesLen[n]);
 
-  return m_bytesLen;
+  return m_bytesLen[n];
 }
 
-uint16_t CAMBE3003Utils::extractPCMFrame(const uint8_t* frame, uint8_t* data) const
+uint16_t CAMBE3003Utils::extractPCMFrame(uint8_t n, const uint8_t* frame, uint8_t* data) const
 {
   swapBytes(data, frame + 5U + 1U + 1U, DVSI_PCM_BYTES);
 
@@ -177,4 +192,22 @@ void CAMBE3003Utils::swapBytes(uint8_t* out, const uint8_t* in, uint16_t length)
   }
 }
 
+const uint8_t* CAMBE3003Utils::getRate(AMBE_MODE mode)
+{
+  // The two directions of a mode share the rate, the packet identifies it
+  switch (mode) {
+    case AMBE_MODE::DSTAR_TO_PCM:
+    case AMBE_MODE::PCM_TO_DSTAR:
+      return DVSI_PKT_DSTAR_FEC;
+    case AMBE_MODE::DMR_NXDN_TO_PCM:
+    case AMBE_MODE::PCM_TO_DMR_NXDN:
+      return DVSI_PKT_MODE33;
+    case AMBE_MODE::YSFDN_TO_PCM:
+    case AMBE_MODE::PCM_TO_YSFDN:
+      return DVSI_PKT_MODE34;
+    default:
+      return nullptr;
+  }
+}
+
 #endif
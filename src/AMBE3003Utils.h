@@ -25,6 +25,14 @@
 
 #include <cstdint>
 
+#if !defined(AMBE3003_CHIPS)
+#define AMBE3003_CHIPS  1
+#endif
+
+// The channels of each chip, and of all of them numbered chip by chip
+const uint8_t AMBE3003_CHANNELS      = 3U;
+const uint8_t AMBE3003_POOL_CHANNELS = AMBE3003_CHIPS * AMBE3003_CHANNELS;
+
 enum class AMBE_MODE {
   NONE,
   DSTAR_TO_PCM,
@@ -40,18 +48,27 @@ class CAMBE3003Utils {
     CAMBE3003Utils();
 
     uint16_t createModeChange(uint8_t n, AMBE_MODE mode, uint8_t* buffer);
+
+    // True when the channel is already set to the rate that the mode needs
+    bool     hasRate(uint8_t n, AMBE_MODE mode) const;
+
+    // After a chip reset no channel has a known rate
+    void     reset();
     uint16_t createAMBEFrame(uint8_t n, const uint8_t* buffer, uint8_t* out) const;
     uint16_t createPCMFrame(uint8_t n, const uint8_t* buffer, uint8_t* out) const;
 
-    uint16_t extractAMBEFrame(const uint8_t* buffer, uint8_t* data) const;
-    uint16_t extractPCMFrame(const uint8_t* buffer, uint8_t* data) const;
+    uint16_t extractAMBEFrame(uint8_t n, const uint8_t* buffer, uint8_t* data) const;
+    uint16_t extractPCMFrame(uint8_t n, const uint8_t* buffer, uint8_t* data) const;
 
   private:
-    AMBE_MODE m_mode;
-    uint8_t   m_bytesLen;
-    uint8_t   m_bitsLen;
+    // Each channel of the chip is configured on its own, so each has its own frame size
+    AMBE_MODE m_mode[AMBE3003_CHANNELS];
+    uint8_t   m_bytesLen[AMBE3003_CHANNELS];
+    uint8_t   m_bitsLen[AMBE3003_CHANNELS];
 
     void swapBytes(uint8_t* out, const uint8_t* in, uint16_t length) const;
+
+    static const uint8_t* getRate(AMBE_MODE mode);
 };
 
 #endif
@@ -0,0 +1,235 @@
+/*
+ *   Copyright (C) 2026 by Jonathan Naylor G4KLX
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "Batch.h"
+
+#include "Globals.h"
+#include "Debug.h"
+
+// How long the session may go without accepting or returning a frame
+const unsigned long BATCH_FRAME_TIMEOUT_MS = 100UL;
+
+const uint16_t RESULT_LENGTH = MAX_BATCH_FRAME_LENGTH + 1U;
+
+CBatch::CBatch() :
+m_input(),
+m_results(),
+m_resolved(),
+m_count(0U),
+m_inLength(0U),
+m_outLength(0U),
+m_next(0U),
+m_inFlight(0U),
+m_done(0U),
+m_start(0UL)
+{
+}
+
+uint8_t CBatch::start(const uint8_t* buffer, uint16_t length)
+{
+  if (m_count > 0U) {
+    DEBUG1("A batch is already being processed");
+    return 0x05U;
+  }
+
+  if (length < BATCH_HEADER_LENGTH) {
+    DEBUG1("Malformed batch DATA command");
+    return 0x02U;
+  }
+
+  uint8_t  count       = buffer[0U];
+  uint16_t frameLength = (buffer[1U] << 0) | (buffer[2U] << 8);
+
+  if ((count == 0U) || (count > MAX_BATCH_FRAMES)) {
+    DEBUG2("Invalid number of frames in a batch", count);
+    return 0x04U;
+  }
+
+  if ((frameLength == 0U) || (frameLength > MAX_BATCH_FRAME_LENGTH)) {
+    DEBUG2("Invalid frame length in a batch", frameLength);
+    return 0x04U;
+  }
+
+  if ((length - BATCH_HEADER_LENGTH) != (count * frameLength)) {
+    DEBUG2("Batch DATA command length is invalid", length);
+    return 0x04U;
+  }
+
+  ::memcpy(m_input, buffer + BATCH_HEADER_LENGTH, count * frameLength);
+
+  for (uint8_t i = 0U; i < count; i++)
+    m_resolved[i] = false;
+
+  m_count     = count;
+  m_inLength  = frameLength;
+  m_outLength = 0U;
+  m_next      = 0U;
+  m_inFlight  = 0U;
+  m_done      = 0U;
+  m_start     = millis();
+
+  return 0x00U;
+}
+
+bool CBatch::isActive() const
+{
+  return m_count > 0U;
+}
+
+bool CBatch::isWaiting() const
+{
+  return m_inFlight > 0U;
+}
+
+bool CBatch::isComplete() const
+{
+  return (m_count > 0U) && (m_done == m_count);
+}
+
+bool CBatch::hasTimedOut() const
+{
+  return (millis() - m_start) >= BATCH_FRAME_TIMEOUT_MS;
+}
+
+const uint8_t* CBatch::getInput(uint16_t& length) const
+{
+  if (m_next >= m_count)
+    return nullptr;
+
+  length = m_inLength;
+
+  return m_input + m_next * m_inLength;
+}
+
+void CBatch::input(uint8_t err)
+{
+  if (m_next >= m_count)
+    return;
+
+  if (err == 0x00U)
+    m_inFlight++;
+  else
+    resolve(m_next, err, nullptr, 0U);
+
+  m_next++;
+  m_start = millis();
+}
+
+uint8_t* CBatch::getOutput()
+{
+  for (uint8_t n = 0U; n < m_next; n++) {
+    if (!m_resolved[n])
+      return m_results + n * RESULT_LENGTH + 1U;
+  }
+
+  return nullptr;
+}
+
+void CBatch::output(const uint8_t* buffer, int16_t length)
+{
+  if (m_inFlight == 0U)
+    return;
+
+  // The session returns frames in the order that they went in
+  for (uint8_t n = 0U; n < m_next; n++) {
+    if (!m_resolved[n]) {
+      if (length < 0)
+        resolve(n, ((-length) > 0xFF) ? 0x04U : uint8_t(-length), nullptr, 0U);
+      else
+        resolve(n, 0x00U, buffer, length);
+
+      m_inFlight--;
+      m_start = millis();
+      return;
+    }
+  }
+}
+
+void CBatch::abandon()
+{
+  for (uint8_t n = 0U; n < m_next; n++) {
+    if (!m_resolved[n])
+      resolve(n, 0x04U, nullptr, 0U);
+  }
+
+  m_inFlight = 0U;
+  m_start    = millis();
+}
+
+void CBatch::resolve(uint8_t n, uint8_t err, const uint8_t* buffer, uint16_t length)
+{
+  uint8_t* result = m_results + n * RESULT_LENGTH;
+
+  if ((err == 0x00U) && (length > MAX_BATCH_FRAME_LENGTH)) {
+    DEBUG2("Batch output frame is too long", length);
+    err = 0x04U;
+  }
+
+  result[0U] = err;
+
+  if (err == 0x00U) {
+    if (m_outLength == 0U)
+      m_outLength = length;
+
+    // Frames from the session are already in place, only the identity frames need copying
+    if ((buffer != nullptr) && (buffer != (result + 1U)))
+      ::memcpy(result + 1U, buffer, m_outLength);
+  }
+
+  m_resolved[n] = true;
+  m_done++;
+}
+
+uint8_t CBatch::getCount() const
+{
+  return m_count;
+}
+
+uint16_t CBatch::getOutputLength() const
+{
+  return m_outLength;
+}
+
+const uint8_t* CBatch::getResults(uint16_t& length)
+{
+  // Close up the gaps left by the frames that have no data
+  uint16_t pos = 0U;
+  for (uint8_t n = 0U; n < m_count; n++) {
+    const uint8_t* result = m_results + n * RESULT_LENGTH;
+
+    uint16_t len = (result[0U] == 0x00U) ? (m_outLength + 1U) : 1U;
+    ::memmove(m_results + pos, result, len);
+
+    pos += len;
+  }
+
+  length = pos;
+
+  return m_results;
+}
+
+void CBatch::reset()
+{
+  m_count     = 0U;
+  m_inLength  = 0U;
+  m_outLength = 0U;
+  m_next      = 0U;
+  m_inFlight  = 0U;
+  m_done      = 0U;
+  m_start     = 0UL;
+}
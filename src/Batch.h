@@ -0,0 +1,92 @@
+/*
+ *   Copyright (C) 2026 by Jonathan Naylor G4KLX
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef	Batch_H
+#define	Batch_H
+
+#include "Config.h"
+
+#include "ModeDefines.h"
+
+#include <cstdint>
+
+#if !defined(MAX_BATCH_FRAMES)
+#define MAX_BATCH_FRAMES  8
+#endif
+
+// The largest frame that may be carried in a batch, a block of PCM
+const uint16_t MAX_BATCH_FRAME_LENGTH = PCM_DATA_LENGTH;
+
+// The batch header is the frame count followed by the frame length
+const uint16_t BATCH_HEADER_LENGTH    = 3U;
+
+// Holds a batch of frames for one session. As many frames are fed into the
+// session as it will accept and the results are collected in the original
+// order, each one prefixed by its own error code.
+class CBatch {
+  public:
+    CBatch();
+
+    uint8_t start(const uint8_t* buffer, uint16_t length);
+
+    bool    isActive() const;
+
+    // Is there a frame waiting for a result from the session?
+    bool    isWaiting() const;
+
+    bool    isComplete() const;
+
+    bool    hasTimedOut() const;
+
+    const uint8_t* getInput(uint16_t& length) const;
+
+    void    input(uint8_t err);
+
+    // Where the output of the oldest frame still waiting goes, so that the session can write it in place
+    uint8_t* getOutput();
+
+    void    output(const uint8_t* buffer, int16_t length);
+
+    // The session has been flushed, so every frame still waiting in it has failed
+    void    abandon();
+
+    uint8_t  getCount() const;
+
+    uint16_t getOutputLength() const;
+
+    // Only valid once the batch is complete
+    const uint8_t* getResults(uint16_t& length);
+
+    void    reset();
+
+  private:
+    uint8_t       m_input[MAX_BATCH_FRAMES * MAX_BATCH_FRAME_LENGTH];
+    uint8_t       m_results[MAX_BATCH_FRAMES * (MAX_BATCH_FRAME_LENGTH + 1U)];
+    bool          m_resolved[MAX_BATCH_FRAMES];
+    uint8_t       m_count;
+    uint16_t      m_inLength;
+    uint16_t      m_outLength;
+    uint8_t       m_next;
+    uint8_t       m_inFlight;
+    uint8_t       m_done;
+    unsigned long m_start;
+
+    void resolve(uint8_t n, uint8_t err, const uint8_t* buffer, uint16_t length);
+};
+
+#endif
@@ -89,31 +89,11 @@ CCodec2::CCodec2(bool is_3200)
 	c2.w.resize(m_pitch);
 	c2.Sn.resize(m_pitch);
 
-	for(int i=0; i<m_pitch; i++)
-		c2.Sn[i] = 1.0;
-	c2.hpf_states[0] = c2.hpf_states[1] = 0.0;
-	for(int i=0; i<2*n_samp; i++)
-		c2.Sn_[i] = 0;
 	kiss.fft_alloc(c2.fft_fwd_cfg, FFT_ENC, false);
 	kiss.fftr_alloc(c2.fftr_fwd_cfg, FFT_ENC, false);
 	make_analysis_window(&c2.c2const, &c2.fft_fwd_cfg, c2.w.data(), c2.W);
 	make_synthesis_window(&c2.c2const, c2.Pn.data());
 	kiss.fftr_alloc(c2.fftr_inv_cfg, FFT_DEC, true);
-	c2.prev_f0_enc = 1/P_MAX_S;
-	c2.bg_est = 0.0;
-	c2.ex_phase = 0.0;
-
-	for(int l=1; l<=MAX_AMP; l++)
-		c2.prev_model_dec.A[l] = 0.0;
-	c2.prev_model_dec.Wo = TWO_PI/c2.c2const.p_max;
-	c2.prev_model_dec.L = PI/c2.prev_model_dec.Wo;
-	c2.prev_model_dec.voiced = 0;
-
-	for(int i=0; i<LPC_ORD; i++)
-	{
-		c2.prev_lsps_dec[i] = i*PI/(LPC_ORD+1);
-	}
-	c2.prev_e_dec = 1;
 
 	nlp.nlp_create(&c2.c2const);
 
@@ -122,14 +102,9 @@ CCodec2::CCodec2(bool is_3200)
 	c2.beta = LPCPF_BETA;
 	c2.gamma = LPCPF_GAMMA;
 
-	c2.xq_enc[0] = c2.xq_enc[1] = 0.0;
-	c2.xq_dec[0] = c2.xq_dec[1] = 0.0;
-
 	c2.smoothing = 0;
 
 	c2.bpf_buf.resize(BPF_N+4*c2.n_samp);
-	for(int i=0; i<BPF_N+4*c2.n_samp; i++)
-		c2.bpf_buf[i] = 0.0;
 
 	c2.softdec = NULL;
 	c2.gray = 1;
@@ -151,6 +126,117 @@ CCodec2::CCodec2(bool is_3200)
 		encode = &CCodec2::codec2_encode_1600;
 		decode = &CCodec2::codec2_decode_1600;
 	}
+
+	codec2_reset();
+}
+
+/*---------------------------------------------------------------------------*\
+
+  FUNCTION....: codec2_reset
+
+  Return the inter-frame state of the encoder and decoder to the values
+  that they have after creation, so that an instance can be reused for
+  a new stream without hearing the end of the previous one.
+
+\*---------------------------------------------------------------------------*/
+
+void CCodec2::codec2_reset()
+{
+	for(int i=0; i<c2.m_pitch; i++)
+		c2.Sn[i] = 1.0;
+	c2.hpf_states[0] = c2.hpf_states[1] = 0.0;
+	for(int i=0; i<2*c2.n_samp; i++)
+		c2.Sn_[i] = 0;
+
+	c2.prev_f0_enc = 1/P_MAX_S;
+	c2.bg_est = 0.0;
+	c2.ex_phase = 0.0;
+
+	for(int l=1; l<=MAX_AMP; l++)
+		c2.prev_model_dec.A[l] = 0.0;
+	c2.prev_model_dec.Wo = TWO_PI/c2.c2const.p_max;
+	c2.prev_model_dec.L = PI/c2.prev_model_dec.Wo;
+	c2.prev_model_dec.voiced = 0;
+
+	for(int i=0; i<LPC_ORD; i++)
+	{
+		c2.prev_lsps_dec[i] = i*PI/(LPC_ORD+1);
+	}
+	c2.prev_e_dec = 1;
+
+	c2.xq_enc[0] = c2.xq_enc[1] = 0.0;
+	c2.xq_dec[0] = c2.xq_dec[1] = 0.0;
+
+	for(int i=0; i<BPF_N+4*c2.n_samp; i++)
+		c2.bpf_buf[i] = 0.0;
+
+	nlp.nlp_reset();
+
+	m_rand_next = 1;
+}
+
+/*---------------------------------------------------------------------------*\
+
+  FUNCTION....: codec2_get_state / codec2_set_state
+
+  Save and restore the inter-frame state of the encoder and decoder, so
+  that one instance can be shared by several streams. The state is
+  CODEC2_STATE_LENGTH bytes, the windows and FFT tables are not
+  included as they never change.
+
+\*---------------------------------------------------------------------------*/
+
+void CCodec2::codec2_get_state(unsigned char *state) const
+{
+	float *p = (float *)state;
+
+	memcpy(p, c2.Sn.data(), c2.m_pitch*sizeof(float));
+	p += c2.m_pitch;
+	*p++ = c2.prev_f0_enc;
+	p += nlp.nlp_get_state(p);
+
+	memcpy(p, c2.Sn_.data(), 2*c2.n_samp*sizeof(float));
+	p += 2*c2.n_samp;
+	*p++ = c2.ex_phase;
+	*p++ = c2.bg_est;
+	*p++ = c2.prev_model_dec.Wo;
+	*p++ = c2.prev_model_dec.L;
+	*p++ = c2.prev_model_dec.voiced;
+	memcpy(p, c2.prev_lsps_dec, sizeof(c2.prev_lsps_dec));
+	p += LPC_ORD;
+	*p++ = c2.prev_e_dec;
+
+	uint32_t next = m_rand_next;
+	memcpy(p++, &next, sizeof(uint32_t));
+
+	assert((unsigned char *)p - state == CODEC2_STATE_LENGTH);
+}
+
+void CCodec2::codec2_set_state(const unsigned char *state)
+{
+	const float *p = (const float *)state;
+
+	memcpy(c2.Sn.data(), p, c2.m_pitch*sizeof(float));
+	p += c2.m_pitch;
+	c2.prev_f0_enc = *p++;
+	p += nlp.nlp_set_state(p);
+
+	memcpy(c2.Sn_.data(), p, 2*c2.n_samp*sizeof(float));
+	p += 2*c2.n_samp;
+	c2.ex_phase = *p++;
+	c2.bg_est = *p++;
+	c2.prev_model_dec.Wo = *p++;
+	c2.prev_model_dec.L = *p++;
+	c2.prev_model_dec.voiced = *p++;
+	memcpy(c2.prev_lsps_dec, p, sizeof(c2.prev_lsps_dec));
+	p += LPC_ORD;
+	c2.prev_e_dec = *p++;
+
+	uint32_t next;
+	memcpy(&next, p++, sizeof(uint32_t));
+	m_rand_next = next;
+
+	assert((const unsigned char *)p - state == CODEC2_STATE_LENGTH);
 }
 
 /*---------------------------------------------------------------------------*\
@@ -386,6 +472,98 @@ void CCodec2::codec2_decode_3200(short speech[], const unsigned char * bits)
 		c2.prev_lsps_dec[i] = lsps[1][i];
 }
 
+/*---------------------------------------------------------------------------*\
+
+  FUNCTION....: codec2_encode_model
+
+  Encodes the model parameters of one 20ms frame into 64 bits at 3200
+  bit/s, for when the harmonic model is already known and there is no
+  speech to analyse. The one voicing decision is used for both 10ms
+  halves of the frame.
+
+\*---------------------------------------------------------------------------*/
+
+void CCodec2::codec2_encode_model(unsigned char *bits, const MODEL *model)
+{
+	float   ak[LPC_ORD+1];
+	float   lsps[LPC_ORD];
+	float   e;
+	int     Wo_index, e_index;
+	int     lspd_indexes[LPC_ORD];
+	int     i;
+	unsigned int nbit = 0;
+
+	assert(c2.mode == 3200);
+
+	memset(bits, '\0', ((codec2_bits_per_frame() + 7) / 8));
+
+	qt.pack(bits, &nbit, model->voiced, 1);
+	qt.pack(bits, &nbit, model->voiced, 1);
+	Wo_index = qt.encode_Wo(&c2.c2const, model->Wo, WO_BITS);
+	qt.pack(bits, &nbit, Wo_index, WO_BITS);
+
+	e = qt.model_to_uq_lsps(lsps, ak, model, LPC_ORD);
+	e_index = qt.encode_energy(e, E_BITS);
+	qt.pack(bits, &nbit, e_index, E_BITS);
+
+	qt.encode_lspds_scalar(lspd_indexes, lsps, LPC_ORD);
+	for(i=0; i<LSPD_SCALAR_INDEXES; i++)
+	{
+		qt.pack(bits, &nbit, lspd_indexes[i], qt.lspd_bits(i));
+	}
+	assert(nbit == (unsigned)codec2_bits_per_frame());
+}
+
+
+/*---------------------------------------------------------------------------*\
+
+  FUNCTION....: codec2_decode_model
+
+  Decodes 64 bits at 3200 bit/s into the model parameters of the second
+  10ms half of the frame, without synthesising any speech. The decoder
+  memories are not used or updated, and the LPC post filter is left to
+  the decoder that the model is passed to.
+
+\*---------------------------------------------------------------------------*/
+
+void CCodec2::codec2_decode_model(MODEL *model, const unsigned char *bits)
+{
+	int     lspd_indexes[LPC_ORD];
+	float   lsps[LPC_ORD];
+	int     Wo_index, e_index;
+	float   e;
+	float   snr;
+	float   ak[LPC_ORD+1];
+	int     i;
+	unsigned int nbit = 0;
+	std::complex<float>    Aw[FFT_ENC];
+
+	assert(c2.mode == 3200);
+
+	for(i=1; i<=MAX_AMP; i++)
+		model->A[i] = 0.0;
+
+	qt.unpack(bits, &nbit, 1);
+	model->voiced = qt.unpack(bits, &nbit, 1);
+
+	Wo_index = qt.unpack(bits, &nbit, WO_BITS);
+	model->Wo = qt.decode_Wo(&c2.c2const, Wo_index, WO_BITS);
+	model->L  = PI/model->Wo;
+
+	e_index = qt.unpack(bits, &nbit, E_BITS);
+	e = qt.decode_energy(e_index, E_BITS);
+
+	for(i=0; i<LSPD_SCALAR_INDEXES; i++)
+	{
+		lspd_indexes[i] = qt.unpack(bits, &nbit, qt.lspd_bits(i));
+	}
+	qt.decode_lspds_scalar(lsps, lspd_indexes, LPC_ORD);
+
+	lsp_to_lpc(lsps, ak, LPC_ORD);
+	qt.aks_to_M2(&(c2.fftr_fwd_cfg), ak, LPC_ORD, model, e, &snr, 0, 0, 0, c2.beta, c2.gamma, Aw);
+	qt.apply_lpc_correction(model);
+}
+
 /*---------------------------------------------------------------------------*\
 
   FUNCTION....: codec2_encode_1600
@@ -1527,9 +1705,8 @@ void CCodec2::synthesise(
 
 int CCodec2::codec2_rand(void)
 {
-	static unsigned long next = 1;
-	next = next * 1103515245 + 12345;
-	return((unsigned)(next/65536) % 32768);
+	m_rand_next = m_rand_next * 1103515245 + 12345;
+	return((unsigned)(m_rand_next/65536) % 32768);
 }
 
 /*---------------------------------------------------------------------------*\
@@ -46,13 +46,21 @@
 
 #define CODEC2_RAND_MAX 32767
 
+/* length of the inter-frame state saved by codec2_get_state for 8 kHz audio */
+#define CODEC2_STATE_LENGTH	3472
+
 class CCodec2
 {
 public:
-	CCodec2(bool is_3200);
+	CCodec2(bool is_3200 = true);
 	~CCodec2();
 	void codec2_encode(unsigned char *bits, const short *speech_in);
 	void codec2_decode(short *speech_out, const unsigned char *bits);
+	void codec2_encode_model(unsigned char *bits, const MODEL *model);
+	void codec2_decode_model(MODEL *model, const unsigned char *bits);
+	void codec2_reset();
+	void codec2_get_state(unsigned char *state) const;
+	void codec2_set_state(const unsigned char *state);
 	void codec2_set_mode(bool);
 	bool codec2_get_mode() {return (c2.mode == 3200); };
 	int  codec2_samples_per_frame();
@@ -97,6 +105,7 @@ private:
 	CQuantize qt;
 	CODEC2 c2;
 	float m_decode_gain;
+	unsigned long m_rand_next;
 };
 
 #endif
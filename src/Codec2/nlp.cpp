@@ -28,6 +28,7 @@
 #include <assert.h>
 #include <math.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "defines.h"
 #include "nlp.h"
@@ -187,14 +188,60 @@ void Cnlp::nlp_create(C2CONST *c2const)
 		snlp.w[i] = 0.5 - 0.5*cosf(2*PI*i/(m/DEC-1));
 	}
 
-	for(i=0; i<PMAX_M; i++)
+	nlp_reset();
+
+	kiss.fft_alloc(snlp.fft_cfg, PE_FFT_SIZE, false);
+}
+
+void Cnlp::nlp_reset()
+{
+	for(int i=0; i<PMAX_M; i++)
 		snlp.sq[i] = 0.0;
 	snlp.mem_x = 0.0;
 	snlp.mem_y = 0.0;
-	for(i=0; i<NLP_NTAP; i++)
+	for(int i=0; i<NLP_NTAP; i++)
 		snlp.mem_fir[i] = 0.0;
 
-	kiss.fft_alloc(snlp.fft_cfg, PE_FFT_SIZE, false);
+	for(size_t i=0; i<snlp.Sn16k.size(); i++)
+		snlp.Sn16k[i] = 0.0;
+}
+
+/*---------------------------------------------------------------------------*\
+
+  nlp_get_state() / nlp_set_state()
+
+  Save and restore the filter memories that carry from one frame to the
+  next, returns the number of floats used. The 16 kHz decimator memory
+  is not included.
+
+\*---------------------------------------------------------------------------*/
+
+int Cnlp::nlp_get_state(float *state) const
+{
+	float *p = state;
+
+	memcpy(p, snlp.sq, sizeof(snlp.sq));
+	p += PMAX_M;
+	*p++ = snlp.mem_x;
+	*p++ = snlp.mem_y;
+	memcpy(p, snlp.mem_fir, sizeof(snlp.mem_fir));
+	p += NLP_NTAP;
+
+	return p - state;
+}
+
+int Cnlp::nlp_set_state(const float *state)
+{
+	const float *p = state;
+
+	memcpy(snlp.sq, p, sizeof(snlp.sq));
+	p += PMAX_M;
+	snlp.mem_x = *p++;
+	snlp.mem_y = *p++;
+	memcpy(snlp.mem_fir, p, sizeof(snlp.mem_fir));
+	p += NLP_NTAP;
+
+	return p - state;
 }
 
 /*---------------------------------------------------------------------------*\
@@ -75,6 +75,9 @@ using NLP = struct nlp_tag
 class Cnlp {
 public:
 	void nlp_create(C2CONST *c2const);
+	void nlp_reset();
+	int  nlp_get_state(float *state) const;
+	int  nlp_set_state(const float *state);
 	void nlp_destroy();
 	float nlp(float Sn[], int n, float *pitch_samples, float *prev_f0);
 	void codec2_fft_inplace(FFT_STATE &cfg, std::complex<float> *inout);
@@ -491,10 +491,10 @@ float CQuantize::decode_Wo(C2CONST *c2const, int index, int bits)
 
 float CQuantize::speech_to_uq_lsps(float lsp[], float ak[], float Sn[], float w[], int m_pitch, int order)
 {
-	int   i, roots;
+	int   i;
 	float Wn[m_pitch];
 	float R[order+1];
-	float e, E;
+	float e;
 	Clpc lpc;
 
 	e = 0.0;
@@ -514,6 +514,62 @@ float CQuantize::speech_to_uq_lsps(float lsp[], float ak[], float Sn[], float w[
 	}
 
 	lpc.autocorrelate(Wn, R, m_pitch, order);
+
+	return autocorrelation_to_uq_lsps(lsp, ak, R, order);
+}
+
+/*---------------------------------------------------------------------------*\
+
+  FUNCTION....: model_to_uq_lsps()
+
+  Finds the LPCs and LSPs of a frame from its harmonic amplitudes rather
+  than from the speech. The autocorrelation of the windowed speech is
+  the inverse DFT of its power spectrum, which is the energy of each
+  harmonic placed at its frequency.
+
+\*---------------------------------------------------------------------------*/
+
+float CQuantize::model_to_uq_lsps(float lsp[], float ak[], const MODEL *model, int order)
+{
+	int   i, m;
+	float R[LPC_ORD+1];
+
+	assert(order <= LPC_ORD);
+
+	for(i=0; i<=LPC_ORD; i++)
+		R[i] = 0.0;
+
+	for(m=1; m<=model->L; m++)
+	{
+		float power = model->A[m]*model->A[m];
+		for(i=0; i<=order; i++)
+			R[i] += power*cosf(model->Wo*(float)(m*i));
+	}
+
+	/* Parseval, the energy of the windowed speech is the energy of both
+	   halves of the FFT_ENC point spectrum */
+
+	for(i=0; i<=order; i++)
+		R[i] *= 2.0/FFT_ENC;
+
+	/* trap 0 energy case as LPC analysis will fail */
+
+	if (R[0] <= 0.0)
+	{
+		for(i=0; i<order; i++)
+			lsp[i] = (PI/order)*(float)i;
+		return 0.0;
+	}
+
+	return autocorrelation_to_uq_lsps(lsp, ak, R, order);
+}
+
+float CQuantize::autocorrelation_to_uq_lsps(float lsp[], float ak[], float R[], int order)
+{
+	int   i, roots;
+	float E;
+	Clpc lpc;
+
 	lpc.levinson_durbin(R, ak, order);
 
 	E = 0.0;
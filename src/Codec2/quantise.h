@@ -54,6 +54,7 @@ public:
 
 	void apply_lpc_correction(MODEL *model);
 	float speech_to_uq_lsps(float lsp[], float ak[], float Sn[], float w[], int m_pitch, int order);
+	float model_to_uq_lsps(float lsp[], float ak[], const MODEL *model, int order);
 	int check_lsp_order(float lsp[], int lpc_order);
 	void bw_expand_lsps(float lsp[], int order, float min_sep_low, float min_sep_high);
 
@@ -61,6 +62,7 @@ private:
 	void compute_weights(const float *x, float *w, int ndim);
 	int find_nearest(const float *codebook, int nb_entries, float *x, int ndim);
 	void lpc_post_filter(FFTR_STATE *fftr_fwd_cfg, float Pw[], float ak[], int order, float beta, float gamma, int bass_boost, float E);
+	float autocorrelation_to_uq_lsps(float lsp[], float ak[], float R[], int order);
 	int lpc_to_lsp (float *a, int lpcrdr, float *freq, int nb, float delta);
 	float cheb_poly_eva(float *coef,float x,int order);
 };
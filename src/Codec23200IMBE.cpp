@@ -0,0 +1,103 @@
+/*
+ *   Copyright (C) 2026 by Jonathan Naylor G4KLX
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "Codec23200IMBE.h"
+
+#include "IMBEUtils.h"
+#include "Debug.h"
+
+#include <cmath>
+
+// The gains from Codec2 harmonic amplitudes to IMBE spectral amplitudes, set so that the level
+// matches the conversion through PCM. An unvoiced IMBE amplitude is a level per unit bandwidth.
+const float VOICED_GAIN   = 0.7F;
+const float UNVOICED_GAIN = 0.1F;
+
+CCodec23200IMBE::CCodec23200IMBE() :
+CQueuedProcessor(),
+m_imbe(-1),
+m_codec2(-1)
+{
+}
+
+CCodec23200IMBE::~CCodec23200IMBE()
+{
+}
+
+uint8_t CCodec23200IMBE::init(uint8_t n)
+{
+  m_imbe = vocoders.allocateIMBE();
+  if (m_imbe < 0)
+    return 0x07U;
+
+  m_codec2 = vocoders.allocateCodec2();
+  if (m_codec2 < 0) {
+    release();
+    return 0x07U;
+  }
+
+  return 0x00U;
+}
+
+void CCodec23200IMBE::release()
+{
+  vocoders.releaseIMBE(m_imbe);
+  vocoders.releaseCodec2(m_codec2);
+  m_imbe   = -1;
+  m_codec2 = -1;
+}
+
+uint8_t CCodec23200IMBE::input(const uint8_t* buffer, uint16_t length)
+{
+  if (m_queue.isFull()) {
+    DEBUG1("IMBE frame queue is full");
+    return 0x05U;
+  }
+
+  if (length != CODEC2_3200_DATA_LENGTH) {
+    DEBUG2("Codec2 3200 frame length is invalid", length);
+    return 0x04U;
+  }
+
+  uint8_t* out = m_queue.next();
+
+  MODEL codec2;
+  vocoders.getCodec2(m_codec2)->codec2_decode_model(&codec2, (const unsigned char*)buffer);
+
+  // Codec2 voices the whole frame or none of it
+  imbe_model imbe;
+  imbe.w0        = codec2.Wo;
+  imbe.num_harms = (codec2.L > int(IMBE_MAX_HARMS)) ? int(IMBE_MAX_HARMS) : codec2.L;
+
+  const float gain = (codec2.voiced != 0) ? VOICED_GAIN : UNVOICED_GAIN / ::sqrtf(codec2.Wo);
+  for (int m = 0; m < imbe.num_harms; m++) {
+    imbe.voiced[m] = codec2.voiced != 0;
+    imbe.amp[m]    = gain * codec2.A[m + 1];
+  }
+
+  int16_t frame[8U];
+  uint32_t start = CStats::cycles();
+  vocoders.getIMBE(m_imbe)->imbe_encode_model(frame, &imbe);
+  stats.stage(STAGE::IMBE_ENCODE, start);
+
+  CIMBEUtils::imbeToPacked(frame, out);
+
+  m_queue.push();
+
+  return 0x00U;
+}
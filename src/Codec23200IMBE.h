@@ -0,0 +1,43 @@
+/*
+ *   Copyright (C) 2026 by Jonathan Naylor G4KLX
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef	Codec23200IMBE_H
+#define	Codec23200IMBE_H
+
+#include "QueuedProcessor.h"
+
+#include "ModeDefines.h"
+
+// Converts through the harmonic models of the two vocoders without synthesising or analysing any audio
+class CCodec23200IMBE final : public CQueuedProcessor<IMBE_DATA_LENGTH> {
+  public:
+    CCodec23200IMBE();
+    virtual ~CCodec23200IMBE();
+
+    virtual uint8_t init(uint8_t n) override;
+
+    virtual void    release() override;
+
+    virtual uint8_t input(const uint8_t* buffer, uint16_t length) override;
+
+  private:
+    int8_t m_imbe;
+    int8_t m_codec2;
+};
+
+#endif
@@ -21,8 +21,8 @@
 #include "Debug.h"
 
 CCodec23200PCM::CCodec23200PCM() :
-m_buffer(),
-m_inUse(false)
+CQueuedProcessor(),
+m_stream(-1)
 {
 }
 
@@ -30,10 +30,25 @@ CCodec23200PCM::~CCodec23200PCM()
 {
 }
 
+uint8_t CCodec23200PCM::init(uint8_t n)
+{
+  m_stream = vocoders.allocateCodec2();
+  if (m_stream < 0)
+    return 0x07U;
+
+  return 0x00U;
+}
+
+void CCodec23200PCM::release()
+{
+  vocoders.releaseCodec2(m_stream);
+  m_stream = -1;
+}
+
 uint8_t CCodec23200PCM::input(const uint8_t* buffer, uint16_t length)
 {
-  if (m_inUse) {
-    DEBUG1("PCM frame is being overwritten");
+  if (m_queue.isFull()) {
+    DEBUG1("PCM frame queue is full");
     return 0x05U;
   }
 
@@ -42,26 +57,17 @@ uint8_t CCodec23200PCM::input(const uint8_t* buffer, uint16_t length)
     return 0x04U;
   }
 
+  uint8_t* out = m_queue.next();
+
   short audio[PCM_DATA_LENGTH / sizeof(short)];
-  codec23200.codec2_decode(audio, (unsigned char*)buffer);
+  vocoders.getCodec2(m_stream)->codec2_decode(audio, (unsigned char*)buffer);
 
   for (uint16_t i = 0U; i < (PCM_DATA_LENGTH / sizeof(short)); i++)
     audio[i] /= 6;
 
-  ::memcpy(m_buffer, audio, PCM_DATA_LENGTH);
+  ::memcpy(out, audio, PCM_DATA_LENGTH);
 
-  m_inUse = true;
+  m_queue.push();
 
   return 0x00U;
 }
-
-int16_t CCodec23200PCM::output(uint8_t* buffer)
-{
-  if (!m_inUse)
-    return 0;
-
-  ::memcpy(buffer, m_buffer, PCM_DATA_LENGTH);
-  m_inUse = false;
-
-  return PCM_DATA_LENGTH;
-}
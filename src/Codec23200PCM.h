@@ -19,22 +19,23 @@
 #ifndef	Codec23200PCM_H
 #define	Codec23200PCM_H
 
-#include "Processor.h"
+#include "QueuedProcessor.h"
 
 #include "ModeDefines.h"
 
-class CCodec23200PCM : public IProcessor {
+class CCodec23200PCM final : public CQueuedProcessor<PCM_DATA_LENGTH> {
   public:
     CCodec23200PCM();
     virtual ~CCodec23200PCM();
 
-    virtual uint8_t input(const uint8_t* buffer, uint16_t length);
+    virtual uint8_t init(uint8_t n);
+
+    virtual void    release();
 
-    virtual int16_t output(uint8_t* buffer);
+    virtual uint8_t input(const uint8_t* buffer, uint16_t length);
 
   private:
-    uint8_t m_buffer[PCM_DATA_LENGTH];
-    bool    m_inUse;
+    int8_t m_stream;
 };
 
 #endif
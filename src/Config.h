@@ -38,6 +38,35 @@
 // 3=One AMBE3003
 #define AMBE_TYPE       3
 
+// Number of AMBE3003 chips when AMBE_TYPE is 3, up to three, each one on its own UART.
+// The channels of all of the chips are pooled and shared by the sessions.
+#define AMBE3003_CHIPS  1
+
+// Number of concurrent transcoding sessions
+#define NUM_SESSIONS    3
+
+// Number of software IMBE and Codec2 vocoders, and the number of streams time sliced onto them.
+// Each stream holds a saved vocoder state, so streams are much cheaper than vocoders.
+#define NUM_IMBE_VOCODERS    2
+#define NUM_IMBE_STREAMS     6
+#define NUM_CODEC2_VOCODERS  2
+#define NUM_CODEC2_STREAMS   6
+
+// Send silent frames straight back as the silence of the output mode without using a vocoder
+#define SILENCE_FAST_PATH
+
+// The peak PCM level below which an audio frame is treated as silence
+#define SILENCE_THRESHOLD  64
+
+// Convert between IMBE and Codec2 through the harmonic models of the vocoders rather than through PCM
+#define MODEL_TRANSCODING
+
+// Number of frames that each processing stage can hold
+#define FRAME_QUEUE_DEPTH  4
+
+// Number of debug records held until they can be output
+#define TRACE_LENGTH  64
+
 // Are LEDs available for status information?
 #define HAS_LEDS
 
@@ -36,8 +36,7 @@ const uint8_t DMR_C_TABLE[] = {46U, 50U, 54U, 58U, 62U, 66U, 70U,  3U,  7U, 11U,
                                23U, 27U, 31U, 35U, 39U, 43U, 47U, 51U, 55U, 59U, 63U, 67U, 71U};
 
 CDMRNXDNFEC::CDMRNXDNFEC() :
-m_buffer(),
-m_inUse(false)
+CQueuedProcessor()
 {
 }
 
@@ -47,8 +46,8 @@ CDMRNXDNFEC::~CDMRNXDNFEC()
 
 uint8_t CDMRNXDNFEC::input(const uint8_t* buffer, uint16_t length)
 {
-  if (m_inUse) {
-    DEBUG1("DMR/NXDN frame is being overwritten");
+  if (m_queue.isFull()) {
+    DEBUG1("DMR/NXDN frame queue is full");
     return 0x05U;
   }
 
@@ -57,6 +56,8 @@ uint8_t CDMRNXDNFEC::input(const uint8_t* buffer, uint16_t length)
     return 0x04U;
   }
 
+  uint8_t* out = m_queue.next();
+
   uint32_t a = 0U;
   uint32_t MASK = 0x800000U;
   for (uint8_t i = 0U; i < 24U; i++, MASK >>= 1) {
@@ -90,37 +91,26 @@ uint8_t CDMRNXDNFEC::input(const uint8_t* buffer, uint16_t length)
   MASK = 0x800000U;
   for (uint8_t i = 0U; i < 24U; i++, MASK >>= 1) {
     uint8_t aPos = DMR_A_TABLE[i];
-    WRITE_BIT1(m_buffer, aPos, a & MASK);
+    WRITE_BIT1(out, aPos, a & MASK);
   }
 
   MASK = 0x400000U;
   for (uint8_t i = 0U; i < 23U; i++, MASK >>= 1) {
     uint8_t bPos = DMR_B_TABLE[i];
-    WRITE_BIT1(m_buffer, bPos, b & MASK);
+    WRITE_BIT1(out, bPos, b & MASK);
   }
 
   MASK = 0x1000000U;
   for (uint8_t i = 0U; i < 25U; i++, MASK >>= 1) {
     uint8_t cPos = DMR_C_TABLE[i];
-    WRITE_BIT1(m_buffer, cPos, c & MASK);
+    WRITE_BIT1(out, cPos, c & MASK);
   }
 
-  m_inUse = true;
+  m_queue.push();
 
   return 0x00U;
 }
 
-int16_t CDMRNXDNFEC::output(uint8_t* buffer)
-{
-  if (!m_inUse)
-    return 0;
-
-  ::memcpy(buffer, m_buffer, DMR_NXDN_DATA_LENGTH);
-  m_inUse = false;
-
-  return DMR_NXDN_DATA_LENGTH;
-}
-
 bool CDMRNXDNFEC::regenerateDMR(uint32_t& a, uint32_t& b, uint32_t& c) const
 {
   uint32_t orig_a = a;
@@ -151,5 +141,7 @@ bool CDMRNXDNFEC::regenerateDMR(uint32_t& a, uint32_t& b, uint32_t& c) const
   if (errsA >= 4U || ((errsA + errsB) >= 6U && errsA >= 2U))
     return false;
 
+  stats.fecCorrections(errsA + errsB);
+
   return true;
 }
@@ -19,22 +19,18 @@
 #ifndef	DMRNXDNFEC_H
 #define	DMRNXDNFEC_H
 
-#include "Processor.h"
+#include "QueuedProcessor.h"
 
 #include "ModeDefines.h"
 
-class CDMRNXDNFEC : public IProcessor {
+class CDMRNXDNFEC final : public CQueuedProcessor<DMR_NXDN_DATA_LENGTH> {
   public:
     CDMRNXDNFEC();
     virtual ~CDMRNXDNFEC();
 
     virtual uint8_t input(const uint8_t* buffer, uint16_t length) override;
 
-    virtual int16_t output(uint8_t* buffer) override;
-
   private:
-    uint8_t m_buffer[DMR_NXDN_DATA_LENGTH];
-    bool    m_inUse;
 
     bool regenerateDMR(uint32_t& a, uint32_t& b, uint32_t& c) const;
 };
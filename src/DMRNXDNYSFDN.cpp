@@ -34,8 +34,7 @@ const uint8_t DMR_C_TABLE[] = {46U, 50U, 54U, 58U, 62U, 66U, 70U,  3U,  7U, 11U,
                                23U, 27U, 31U, 35U, 39U, 43U, 47U, 51U, 55U, 59U, 63U, 67U, 71U};
 
 CDMRNXDNYSFDN::CDMRNXDNYSFDN() :
-m_buffer(),
-m_inUse(false)
+CQueuedProcessor()
 {
 }
 
@@ -45,8 +44,8 @@ CDMRNXDNYSFDN::~CDMRNXDNYSFDN()
 
 uint8_t CDMRNXDNYSFDN::input(const uint8_t* buffer, uint16_t length)
 {
-  if (m_inUse) {
-    DEBUG1("YSF DN frame is being overwritten");
+  if (m_queue.isFull()) {
+    DEBUG1("YSF DN frame queue is full");
     return 0x05U;
   }
 
@@ -55,6 +54,8 @@ uint8_t CDMRNXDNYSFDN::input(const uint8_t* buffer, uint16_t length)
     return 0x04U;
   }
 
+  uint8_t* out = m_queue.next();
+
   uint32_t a = 0U;
   uint32_t MASK = 0x800000U;
   for (uint8_t i = 0U; i < 24U; i++, MASK >>= 1) {
@@ -89,47 +90,36 @@ uint8_t CDMRNXDNYSFDN::input(const uint8_t* buffer, uint16_t length)
   for (uint8_t i = 0U; i < 12U; i++) {
     bool s = (a << (20U + i)) & 0x80000000U;
 
-    WRITE_BIT1(m_buffer, 3U * i + 0U, s);
-    WRITE_BIT1(m_buffer, 3U * i + 1U, s);
-    WRITE_BIT1(m_buffer, 3U * i + 2U, s);
+    WRITE_BIT1(out, 3U * i + 0U, s);
+    WRITE_BIT1(out, 3U * i + 1U, s);
+    WRITE_BIT1(out, 3U * i + 2U, s);
   }
   
   for (uint8_t i = 0U; i < 12U; i++) {
     bool s = (b << (20U + i)) & 0x80000000U;
 
-    WRITE_BIT1(m_buffer, 3U * (i + 12U) + 0U, s);
-    WRITE_BIT1(m_buffer, 3U * (i + 12U) + 1U, s);
-    WRITE_BIT1(m_buffer, 3U * (i + 12U) + 2U, s);
+    WRITE_BIT1(out, 3U * (i + 12U) + 0U, s);
+    WRITE_BIT1(out, 3U * (i + 12U) + 1U, s);
+    WRITE_BIT1(out, 3U * (i + 12U) + 2U, s);
   }
   
   for (uint8_t i = 0U; i < 3U; i++) {
     bool s = (c << (7U + i)) & 0x80000000U;
 
-    WRITE_BIT1(m_buffer, 3U * (i + 24U) + 0U, s);
-    WRITE_BIT1(m_buffer, 3U * (i + 24U) + 1U, s);
-    WRITE_BIT1(m_buffer, 3U * (i + 24U) + 2U, s);
+    WRITE_BIT1(out, 3U * (i + 24U) + 0U, s);
+    WRITE_BIT1(out, 3U * (i + 24U) + 1U, s);
+    WRITE_BIT1(out, 3U * (i + 24U) + 2U, s);
   }
 
   for (uint8_t i = 0U; i < 22U; i++) {
     bool s = (c << (10U + i)) & 0x80000000U;
 
-    WRITE_BIT1(m_buffer, i + 81U, s);
+    WRITE_BIT1(out, i + 81U, s);
   }
   
-  WRITE_BIT1(m_buffer, 103U, false);
+  WRITE_BIT1(out, 103U, false);
 
-  m_inUse = true;
+  m_queue.push();
 
   return 0x00U;
 }
-
-int16_t CDMRNXDNYSFDN::output(uint8_t* buffer)
-{
-  if (!m_inUse)
-    return 0;
-
-  ::memcpy(buffer, m_buffer, YSFDN_DATA_LENGTH);
-  m_inUse = false;
-
-  return YSFDN_DATA_LENGTH;
-}
@@ -21,6 +21,7 @@
 #include "AMBEPRNGTable.h"
 #include "Golay.h"
 #include "Debug.h"
+#include "Utils.h"
 
 const uint8_t BIT_MASK_TABLE[] = {0x80U, 0x40U, 0x20U, 0x10U, 0x08U, 0x04U, 0x02U, 0x01U};
 
@@ -36,8 +37,7 @@ const uint8_t DSTAR_C_TABLE[] = {4U, 10U, 16U, 22U, 28U, 34U, 40U, 46U, 52U, 58U
                                  5U, 11U, 17U, 23U, 29U, 35U, 41U, 47U, 53U, 59U, 65U, 71U};
 
 CDStarFEC::CDStarFEC() :
-m_buffer(),
-m_inUse(false)
+CQueuedProcessor()
 {
 }
 
@@ -47,8 +47,8 @@ CDStarFEC::~CDStarFEC()
 
 uint8_t CDStarFEC::input(const uint8_t* buffer, uint16_t length)
 {
-  if (m_inUse) {
-    DEBUG1("D-Star frame is being overwritten");
+  if (m_queue.isFull()) {
+    DEBUG1("D-Star frame queue is full");
     return 0x05U;
   }
 
@@ -57,6 +57,8 @@ uint8_t CDStarFEC::input(const uint8_t* buffer, uint16_t length)
     return 0x04U;
   }
 
+  uint8_t* out = m_queue.next();
+
   uint32_t a = 0U;
   uint32_t b = 0U;
   uint32_t c = 0U;
@@ -77,31 +79,23 @@ uint8_t CDStarFEC::input(const uint8_t* buffer, uint16_t length)
 
   MASK = 0x800000U;
   for (uint8_t i = 0U; i < 24U; i++) {
-    WRITE_BIT1(m_buffer, DSTAR_A_TABLE[i], a & MASK);
-    WRITE_BIT1(m_buffer, DSTAR_B_TABLE[i], b & MASK);
-    WRITE_BIT1(m_buffer, DSTAR_C_TABLE[i], c & MASK);
+    WRITE_BIT1(out, DSTAR_A_TABLE[i], a & MASK);
+    WRITE_BIT1(out, DSTAR_B_TABLE[i], b & MASK);
+    WRITE_BIT1(out, DSTAR_C_TABLE[i], c & MASK);
 
     MASK >>= 1;
   }
 
-  m_inUse = true;
+  m_queue.push();
 
   return 0x00U;
 }
 
-int16_t CDStarFEC::output(uint8_t* buffer)
-{
-  if (!m_inUse)
-    return 0;
-
-  ::memcpy(buffer, m_buffer, DSTAR_DATA_LENGTH);
-  m_inUse = false;
-
-  return DSTAR_DATA_LENGTH;
-}
-
 void CDStarFEC::regenerateDStar(uint32_t& a, uint32_t& b) const
 {
+  uint32_t orig_a = a;
+  uint32_t orig_b = b;
+
   uint32_t data;
   CGolay::decode24128(a, data);
 
@@ -117,4 +111,6 @@ void CDStarFEC::regenerateDStar(uint32_t& a, uint32_t& b) const
   b = CGolay::encode24128(datb);
 
   b ^= p;
+
+  stats.fecCorrections(::countBits32(a ^ orig_a) + ::countBits32(b ^ orig_b));
 }
@@ -19,22 +19,18 @@
 #ifndef	DStarFEC_H
 #define	DStarFEC_H
 
-#include "Processor.h"
+#include "QueuedProcessor.h"
 
 #include "ModeDefines.h"
 
-class CDStarFEC : public IProcessor {
+class CDStarFEC final : public CQueuedProcessor<DSTAR_DATA_LENGTH> {
   public:
     CDStarFEC();
     virtual ~CDStarFEC();
 
     virtual uint8_t input(const uint8_t* buffer, uint16_t length) override;
 
-    virtual int16_t output(uint8_t* buffer) override;
-
   private:
-    uint8_t m_buffer[DSTAR_DATA_LENGTH];
-    bool    m_inUse;
 
     void regenerateDStar(uint32_t& a, uint32_t& b) const;
 };
@@ -37,9 +37,7 @@ uint8_t CDStarPCM::init(uint8_t n)
 {
   m_n = n;
 
-  ambe.init(m_n, AMBE_MODE::DSTAR_TO_PCM);
-
-  return 0x00U;
+  return ambe.init(m_n, AMBE_MODE::DSTAR_TO_PCM);
 }
 
 uint8_t CDStarPCM::input(const uint8_t* buffer, uint16_t length)
@@ -68,4 +66,14 @@ int16_t CDStarPCM::output(uint8_t* buffer)
   }
 }
 
+void CDStarPCM::flush()
+{
+  ambe.drain(m_n);
+}
+
+uint8_t CDStarPCM::space() const
+{
+  return ambe.space(m_n);
+}
+
 #endif
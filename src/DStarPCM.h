@@ -25,7 +25,7 @@
 
 #include "Processor.h"
 
-class CDStarPCM : public IProcessor {
+class CDStarPCM final : public IProcessor {
   public:
     CDStarPCM();
     virtual ~CDStarPCM();
@@ -36,6 +36,10 @@ class CDStarPCM : public IProcessor {
 
     virtual int16_t output(uint8_t* buffer) override;
 
+    virtual void    flush() override;
+
+    virtual uint8_t space() const override;
+
   private:
     uint8_t m_n;
 };
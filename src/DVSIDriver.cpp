@@ -26,10 +26,18 @@ const uint8_t DVSI_START_BYTE = 0x61U;
 const uint8_t  GET_VERSION_ID[]   = { DVSI_START_BYTE, 0x00U, 0x01U, 0x00U, 0x30U };
 const uint16_t GET_VERSION_ID_LEN = 5U;
 
+// How long each step of a reset takes in milliseconds
+const uint32_t DVSI_RESET_TIME = 100U;
+const uint32_t DVSI_BOOT_TIME  = 10U;
+const uint32_t DVSI_PROBE_TIME = 10U;
+
 CDVSIDriver::CDVSIDriver(int rxPin, int txPin, int resetPin, int rtsPin) :
 m_serial(rxPin, txPin),
 m_resetPin(resetPin),
 m_rtsPin(rtsPin),
+m_state(DVSI_STATE::READY),
+m_timer(0U),
+m_tx(),
 m_buffer(),
 m_len(0U),
 m_ptr(0U)
@@ -50,30 +58,101 @@ void CDVSIDriver::reset()
 {
   DEBUG1("Resetting the AMBE chip");
 
-  digitalWrite(m_resetPin, LOW);
-  delay(100U);
-  digitalWrite(m_resetPin, HIGH);
-  delay(10U);
+  // Nothing held for the old chip state is wanted now, anything written from here on waits for the reset
+  m_tx.reset();
 
-  write(GET_VERSION_ID, GET_VERSION_ID_LEN);
-  delay(10U);
+  digitalWrite(m_resetPin, LOW);
 
-  while (m_serial.available() > 0)
-    m_serial.read();
+  m_state = DVSI_STATE::RESET;
+  m_timer = millis();
 }
 
 bool CDVSIDriver::ready() const
 {
-  return digitalRead(m_rtsPin) == LOW;
+  return (m_state == DVSI_STATE::READY) && (digitalRead(m_rtsPin) == LOW);
 }
 
-void CDVSIDriver::write(const uint8_t* buffer, uint16_t length)
+bool CDVSIDriver::isBusy() const
 {
-  m_serial.write(buffer, length);
+  return (m_state != DVSI_STATE::READY) || !m_tx.isEmpty();
+}
+
+bool CDVSIDriver::write(const uint8_t* buffer, uint16_t length)
+{
+  // Packets go to the chip in order, so once one is held so are all that follow it
+  if (m_tx.isEmpty() && ready()) {
+    m_serial.write(buffer, length);
+    stats.dvsiSent();
+    return true;
+  }
+
+  if (m_tx.isFull() || (length > DVSI_TX_LENGTH)) {
+    DEBUG1("The AMBE chip transmit queue is full");
+    return false;
+  }
+
+  stats.rtsBusy();
+
+  ::memcpy(m_tx.next(), buffer, length);
+  m_tx.push(length);
+
+  return true;
+}
+
+void CDVSIDriver::service()
+{
+  uint32_t elapsed = millis() - m_timer;
+
+  switch (m_state) {
+    case DVSI_STATE::RESET:
+      if (elapsed >= DVSI_RESET_TIME) {
+        digitalWrite(m_resetPin, HIGH);
+        m_state = DVSI_STATE::BOOT;
+        m_timer = millis();
+      }
+      return;
+
+    case DVSI_STATE::BOOT:
+      if (elapsed >= DVSI_BOOT_TIME) {
+        m_serial.write(GET_VERSION_ID, GET_VERSION_ID_LEN);
+        stats.dvsiSent();
+        m_state = DVSI_STATE::PROBE;
+        m_timer = millis();
+      }
+      return;
+
+    case DVSI_STATE::PROBE:
+      if (elapsed < DVSI_PROBE_TIME)
+        return;
+
+      // The reply to the probe, and anything sent during the reset, is not wanted
+      while (m_serial.available() > 0)
+        m_serial.read();
+
+      m_ptr   = 0U;
+      m_len   = 0U;
+      m_state = DVSI_STATE::READY;
+      break;
+
+    default:
+      break;
+  }
+
+  while (!m_tx.isEmpty() && ready()) {
+    m_serial.write(m_tx.peek(), m_tx.length());
+    m_tx.discard();
+
+    stats.dvsiSent();
+  }
 }
 
 uint16_t CDVSIDriver::read(uint8_t* buffer)
 {
+  service();
+
+  if (m_state != DVSI_STATE::READY)
+    return 0U;
+
   while (m_serial.available() > 0) {
     uint8_t c = m_serial.read();
 
@@ -98,6 +177,13 @@ uint16_t CDVSIDriver::read(uint8_t* buffer)
       m_len |= (val << 0) & 0x00FFU;
       m_len += 4U;	// The length in the DVSI message doesn't include the first four bytes
       m_ptr  = 3U;
+
+      // A length that cannot fit is a corrupt header, look for the next start byte
+      if (m_len > DVSI_MAX_PACKET_LENGTH) {
+        DEBUG2("Invalid length from the AMBE chip", m_len);
+        m_ptr = 0U;
+        m_len = 0U;
+      }
     } else {
       // Any other bytes are added to the buffer
       m_buffer[m_ptr] = c;
@@ -106,6 +192,8 @@ uint16_t CDVSIDriver::read(uint8_t* buffer)
       // The full packet has been received, process it
       if (m_ptr == m_len) {
         DEBUG1("Read from the chip");
+        stats.dvsiReceived();
+
         ::memcpy(buffer, m_buffer, m_len);
         uint16_t length = m_len;
 
@@ -23,21 +23,54 @@
 
 #if AMBE_TYPE > 0
 
+#include "FrameQueue.h"
+
 #include <Arduino.h>
 
 #include <cstdint>
 
+// The longest packet written to a chip, PCM with its headers
+const uint16_t DVSI_TX_LENGTH = 400U;
+
+// The longest packet read from a chip, the buffers passed to read() must hold this much
+const uint16_t DVSI_MAX_PACKET_LENGTH = 500U;
+
+// Every frame that the channels of one chip can have outstanding, and room for control packets
+#if AMBE_TYPE == 3
+const uint8_t  DVSI_TX_DEPTH  = (3U * FRAME_QUEUE_DEPTH) + 2U;
+#else
+const uint8_t  DVSI_TX_DEPTH  = FRAME_QUEUE_DEPTH + 2U;
+#endif
+
+// The steps of a chip reset, each one waits for a time rather than blocking
+enum class DVSI_STATE {
+  RESET,
+  BOOT,
+  PROBE,
+  READY
+};
+
 class CDVSIDriver {
   public:
     CDVSIDriver(int rxPin, int txPin, int resetPin, int rtsPin);
 
     void     startup();
 
+    // Starts a reset of the chip, service() then carries it through
     void     reset();
 
+    // True when the chip is out of reset and RTS is low
     bool     ready() const;
 
-    void     write(const uint8_t* buffer, uint16_t length);
+    // True while the chip is resetting or packets are held for it, so no replies can be expected
+    bool     isBusy() const;
+
+    // Sends the packet now if the chip is ready, else holds it until the chip is,
+    // false if there is no room to hold it
+    bool     write(const uint8_t* buffer, uint16_t length);
+
+    // Moves a reset on and sends any held packets that the chip is now ready for
+    void     service();
 
     uint16_t read(uint8_t* buffer);
 
@@ -45,7 +78,10 @@ class CDVSIDriver {
     HardwareSerial m_serial;
     int            m_resetPin;
     int            m_rtsPin;
-    uint8_t        m_buffer[512U];
+    DVSI_STATE     m_state;
+    uint32_t       m_timer;
+    CFrameQueue<DVSI_TX_LENGTH, DVSI_TX_DEPTH> m_tx;
+    uint8_t        m_buffer[DVSI_MAX_PACKET_LENGTH];
     uint16_t       m_len;
     uint16_t       m_ptr;
 };
@@ -21,22 +21,28 @@
 
 #include "Globals.h"
 
+#if AMBE3003_CHIPS > 3
+#error "No more than three AMBE3003 chips are supported"
+#endif
+
+// The first chip uses the pins of the single chip board, the second those of the second
+// AMBE3000 of the dual chip board, the third a spare UART on the Zio connector
 #if defined(NUCLEO_STM32F722ZE)
-#define USART_TX        PG14     // Arduino D1
-#define USART_RX        PG9      // Arduino D0
-#define AMBE_RESET      PF13     // Arduino D7
-#define AMBE_RTS        PA3      // Arduino A0
+const int USART_TX[]   = { PG14, PE8, PD5 };    // Arduino D1,  D42, D53
+const int USART_RX[]   = { PG9,  PE7, PD6 };    // Arduino D0,  D41, D52
+const int AMBE_RESET[] = { PF13, PF14, PE11 };  // Arduino D7,  D4,  D5
+const int AMBE_RTS[]   = { PA3,  PF3, PC0 };    // Arduino A0,  A3,  A1
 #elif defined(NUCLEO_STM32H723ZG)
-#define USART_TX        PB6      // Arduino D1
-#define USART_RX        PB7      // Arduino D0
-#define AMBE_RESET      PG12     // Arduino D7
-#define AMBE_RTS        PA3      // Arduino A0
+const int USART_TX[]   = { PB6,  PE8, PD5 };    // Arduino D1,  D42, D53
+const int USART_RX[]   = { PB7,  PE7, PD6 };    // Arduino D0,  D41, D52
+const int AMBE_RESET[] = { PG12, PE14, PE11 };  // Arduino D7,  D4,  D5
+const int AMBE_RTS[]   = { PA3,  PB1, PC0 };    // Arduino A0,  A3,  A1
 #else
 #error "Unknown hardware"
 #endif
 
-CDVSIDriver3003::CDVSIDriver3003() :
-CDVSIDriver(USART_RX, USART_TX, AMBE_RESET, AMBE_RTS)
+CDVSIDriver3003::CDVSIDriver3003(uint8_t chip) :
+CDVSIDriver(USART_RX[chip], USART_TX[chip], AMBE_RESET[chip], AMBE_RTS[chip])
 {
 }
 
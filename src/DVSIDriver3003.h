@@ -27,7 +27,8 @@
 
 class CDVSIDriver3003 : public CDVSIDriver {
   public:
-    CDVSIDriver3003();
+    // The chip number selects the UART and pins that it is wired to
+    CDVSIDriver3003(uint8_t chip);
 
   private:
 };
@@ -23,11 +23,12 @@
 #include "Globals.h"
 
 #if defined(DEBUGGING)
-#define  DEBUG1(a)          serial.writeDebug((a))
-#define  DEBUG2(a,b)        serial.writeDebug((a),(b))
-#define  DEBUG3(a,b,c)      serial.writeDebug((a),(b),(c))
-#define  DEBUG4(a,b,c,d)    serial.writeDebug((a),(b),(c),(d))
-#define  DEBUG5(a,b,c,d,e)  serial.writeDebug((a),(b),(c),(d),(e))
+// Only a record is stored here, the text is output later when the loop is idle
+#define  DEBUG1(a)          trace.log((a))
+#define  DEBUG2(a,b)        trace.log((a),(b))
+#define  DEBUG3(a,b,c)      trace.log((a),(b),(c))
+#define  DEBUG4(a,b,c,d)    trace.log((a),(b),(c),(d))
+#define  DEBUG5(a,b,c,d,e)  trace.log((a),(b),(c),(d),(e))
 #define  DEBUG_DUMP(a,b)    serial.writeDebugDump((a),(b))
 #else
 #define  DEBUG1(a)
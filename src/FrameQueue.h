@@ -0,0 +1,134 @@
+/*
+ *   Copyright (C) 2026 by Jonathan Naylor G4KLX
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef	FrameQueue_H
+#define	FrameQueue_H
+
+#include "Config.h"
+
+#include <cstdint>
+#include <cstring>
+
+#if !defined(FRAME_QUEUE_DEPTH)
+#define FRAME_QUEUE_DEPTH  4
+#endif
+
+// A FIFO of DEPTH frames of up to LENGTH bytes. A frame is built in
+// place in the slot returned by next() and only becomes visible once push()
+// is called, so a failed conversion leaves the queue untouched.
+template <uint16_t LENGTH, uint8_t DEPTH = FRAME_QUEUE_DEPTH>
+class CFrameQueue {
+  public:
+    CFrameQueue() :
+    m_frames(),
+    m_lengths(),
+    m_head(0U),
+    m_tail(0U),
+    m_count(0U)
+    {
+    }
+
+    bool isEmpty() const
+    {
+      return m_count == 0U;
+    }
+
+    bool isFull() const
+    {
+      return m_count >= DEPTH;
+    }
+
+    uint8_t count() const
+    {
+      return m_count;
+    }
+
+    uint8_t space() const
+    {
+      return DEPTH - m_count;
+    }
+
+    uint8_t* next()
+    {
+      return m_frames[m_tail];
+    }
+
+    void push(uint16_t length = LENGTH)
+    {
+      if (m_count >= DEPTH)
+        return;
+
+      m_lengths[m_tail] = length;
+
+      m_tail = (m_tail + 1U) % DEPTH;
+      m_count++;
+    }
+
+    // The length of the oldest frame, zero when the queue is empty
+    uint16_t length() const
+    {
+      if (m_count == 0U)
+        return 0U;
+
+      return m_lengths[m_head];
+    }
+
+    // The oldest frame where it is held, valid until it is discarded
+    const uint8_t* peek() const
+    {
+      return m_frames[m_head];
+    }
+
+    uint16_t pop(uint8_t* buffer)
+    {
+      if (m_count == 0U)
+        return 0U;
+
+      uint16_t length = m_lengths[m_head];
+      ::memcpy(buffer, m_frames[m_head], length);
+
+      discard();
+
+      return length;
+    }
+
+    void discard()
+    {
+      if (m_count == 0U)
+        return;
+
+      m_head = (m_head + 1U) % DEPTH;
+      m_count--;
+    }
+
+    void reset()
+    {
+      m_head  = 0U;
+      m_tail  = 0U;
+      m_count = 0U;
+    }
+
+  private:
+    uint8_t  m_frames[DEPTH][LENGTH];
+    uint16_t m_lengths[DEPTH];
+    uint8_t  m_head;
+    uint8_t  m_tail;
+    uint8_t  m_count;
+};
+
+#endif
@@ -21,10 +21,6 @@
 
 #include <Arduino.h>
 
-#include "IMBE/imbe_vocoder.h"
-
-#include "Codec2/codec2.h"
-
 #if AMBE_TYPE == 3
 #include "AMBE3003Driver.h"
 #include "DVSIDriver3003.h"
@@ -37,79 +33,23 @@
 #include "DVSIDriver30001.h"
 #endif
 
-#include "Codec23200PCM.h"
-#include "PCMCodec23200.h"
-#include "YSFDNDMRNXDN.h"
-#include "DMRNXDNYSFDN.h"
-#include "IMBEIMBEFEC.h"
-#include "IMBEFECIMBE.h"
-#include "DMRNXDNFEC.h"
-#include "DMRNXDNPCM.h"
-#include "PCMDMRNXDN.h"
-#include "IMBEFECPCM.h"
-#include "PCMIMBEFEC.h"
 #include "SerialPort.h"
 #include "LEDDriver.h"
-#include "PCMYSFDN.h"
-#include "YSFDNPCM.h"
-#include "YSFDNFEC.h"
-#include "DStarFEC.h"
-#include "DStarPCM.h"
-#include "PCMDStar.h"
-#include "YSFDNPCM.h"
-#include "MuLawPCM.h"
-#include "PCMMuLaw.h"
-#include "ALawPCM.h"
-#include "PCMALaw.h"
-#include "IMBEFEC.h"
-#include "IMBEPCM.h"
-#include "PCMIMBE.h"
+#include "Stats.h"
+#include "Trace.h"
+#include "Vocoders.h"
 #include "Config.h"
 #include "Debug.h"
 
 extern CSerialPort     serial;
 
-extern CDStarFEC       dstarfec;
-extern CDMRNXDNFEC     dmrnxdnfec;
-extern CYSFDNFEC       ysfdnfec;
-extern CIMBEFEC        imbefec;
-
-#if AMBE_TYPE > 0
-extern CYSFDNPCM       ysfdnpcm;
-extern CDStarPCM       dstarpcm;
-extern CDMRNXDNPCM     dmrnxdnpcm;
-#endif
-
-extern CIMBEPCM        imbepcm;
-extern CIMBEFECPCM     imbefecpcm;
-extern CCodec23200PCM  codec23200pcm;
-
-#if AMBE_TYPE > 0
-extern CPCMYSFDN       pcmysfdn;
-extern CPCMDStar       pcmdstar;
-extern CPCMDMRNXDN     pcmdmrnxdn;
-#endif
-
-extern CPCMIMBE        pcmimbe;
-extern CPCMIMBEFEC     pcmimbefec;
-extern CPCMCodec23200  pcmcodec23200;
-
-extern CYSFDNDMRNXDN   ysfdndmrnxdn;
-extern CDMRNXDNYSFDN   dmrnxdnysfdn;
-
-extern CIMBEIMBEFEC    imbeimbefec;
-extern CIMBEFECIMBE    imbefecimbe;
-
-extern CALawPCM        alawpcm;
-extern CPCMALaw        pcmalaw;
-extern CMuLawPCM       mulawpcm;
-extern CPCMMuLaw       pcmmulaw;
+extern CStats          stats;
+extern CTrace          trace;
 
-extern imbe_vocoder    imbe;
-extern CCodec2         codec23200;
+extern CVocoders       vocoders;
 
 #if AMBE_TYPE == 3
-extern CDVSIDriver3003 dvsi;
+extern CDVSIDriver3003 dvsi[AMBE3003_CHIPS];
 extern CAMBE3003Driver ambe;
 #endif
 #if AMBE_TYPE == 2
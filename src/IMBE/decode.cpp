@@ -34,6 +34,7 @@
 #include "imbe_vocoder_impl.h"
 
 #include <cstring>
+#include <cmath>
 
 
 
@@ -67,3 +68,25 @@ void imbe_vocoder_impl::decode(IMBE_PARAM *imbe_param, Word16 *frame_vector, Wor
 	for(j = 0; j < FRAME; j++)
 		snd[j] = add(snd[j], snd_tmp[j]);
 }
+
+
+void imbe_vocoder_impl::decode_model(IMBE_PARAM *imbe_param, Word16 *frame_vector, imbe_model *model)
+{
+	Word16 j;
+
+	decode_frame_vector(imbe_param, frame_vector);
+	v_uv_decode(imbe_param);
+	sa_decode(imbe_param);
+
+	// The amplitudes are left unenhanced, the decoder that they are passed to has its own post filter
+
+	// fund_freq holds w0 / PI in Q1.31
+	model->w0        = (float)imbe_param->fund_freq * (float)(M_PI / 2147483648.0);
+	model->num_harms = imbe_param->num_harms;
+
+	for(j = 0; j < imbe_param->num_harms; j++)
+	{
+		model->voiced[j] = imbe_param->v_uv_dsn[j] != 0;
+		model->amp[j]    = imbe_param->sa[j];
+	}
+}
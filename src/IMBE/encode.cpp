@@ -37,6 +37,8 @@
 #include "ch_encode.h"
 #include "imbe_vocoder_impl.h"
 
+#include <cmath>
+
 
 
 
@@ -97,3 +99,75 @@ void imbe_vocoder_impl::encode(IMBE_PARAM *imbe_param, Word16 *frame_vector, Wor
 	sa_encode(imbe_param);
 	encode_frame_vector(imbe_param, frame_vector);
 }
+
+
+void imbe_vocoder_impl::encode_model(IMBE_PARAM *imbe_param, Word16 *frame_vector, const imbe_model *model)
+{
+	Word16 i, j, tmp, num_harms, num_bands, band_cnt, band_len, voiced_cnt, uv_harms_cnt, b1_vec, voiced;
+	float pitch, amp;
+
+	// The pitch period in samples, limited to what b0 can carry
+	pitch = (float)(2.0 * M_PI) / model->w0;
+	if(pitch < 19.5f)
+		pitch = 19.5f;
+	else if(pitch > 123.25f)
+		pitch = 123.25f;
+
+	imbe_param->ref_pitch = (Word16)(pitch * 256.0f);                       // Q8.8
+
+	// The number of harmonics and bands as v_uv_det finds them
+	tmp = shr( add( shr(imbe_param->ref_pitch, 1),  CNST_0_25_Q8_8), 8);
+	num_harms = extract_h((UWord32)CNST_0_9254_Q0_16 * tmp);
+	if(num_harms < NUM_HARMS_MIN)
+		num_harms = NUM_HARMS_MIN;
+	else if(num_harms > NUM_HARMS_MAX)
+		num_harms = NUM_HARMS_MAX;
+
+	if(num_harms <= 36)
+		num_bands = extract_h((UWord32)(num_harms + 2) * CNST_0_33_Q0_16);
+	else
+		num_bands = NUM_BANDS_MAX;
+
+	imbe_param->num_harms = num_harms;
+	imbe_param->num_bands = num_bands;
+
+	// A band of three harmonics, the last taking any left over, is voiced when most of its harmonics are
+	b1_vec       = 0;
+	uv_harms_cnt = 0;
+	i            = 0;
+	for(band_cnt = 0; band_cnt < num_bands; band_cnt++)
+	{
+		band_len = (band_cnt < num_bands - 1) ? 3 : num_harms - i;
+
+		voiced_cnt = 0;
+		for(j = i; j < i + band_len; j++)
+			if(j < model->num_harms && model->voiced[j])
+				voiced_cnt++;
+
+		voiced = (2 * voiced_cnt > band_len) ? 1 : 0;
+		b1_vec = (b1_vec << 1) | voiced;
+
+		for(j = i; j < i + band_len; j++)
+		{
+			amp = (j < model->num_harms) ? model->amp[j] : 0.0f;
+			if(amp < 1.0f)
+				amp = 1.0f;
+			else if(amp > 32767.0f)
+				amp = 32767.0f;
+
+			imbe_param->sa[j]       = (Word16)(amp + 0.5f);
+			imbe_param->v_uv_dsn[j] = voiced;
+			if(!voiced)
+				uv_harms_cnt++;
+		}
+
+		i += band_len;
+	}
+
+	imbe_param->l_uv     = uv_harms_cnt;
+	imbe_param->b_vec[1] = b1_vec;
+	imbe_param->b_vec[0] = shr( sub(imbe_param->ref_pitch, 0x1380), 7);  // Pitch encode  fix(2*pitch - 39)
+
+	sa_encode(imbe_param);
+	encode_frame_vector(imbe_param, frame_vector);
+}
@@ -21,3 +21,27 @@ void imbe_vocoder::imbe_decode(int16_t *frame_vector, int16_t *snd)
         Impl->imbe_decode(frame_vector, snd);
 }
 
+void imbe_vocoder::imbe_decode_model(int16_t *frame_vector, imbe_model *model)
+{
+        Impl->imbe_decode_model(frame_vector, model);
+}
+
+void imbe_vocoder::imbe_encode_model(int16_t *frame_vector, const imbe_model *model)
+{
+        Impl->imbe_encode_model(frame_vector, model);
+}
+
+void imbe_vocoder::reset(void)
+{
+        Impl->reset();
+}
+
+void imbe_vocoder::get_state(uint8_t *state) const
+{
+        Impl->get_state(state);
+}
+
+void imbe_vocoder::set_state(const uint8_t *state)
+{
+        Impl->set_state(state);
+}
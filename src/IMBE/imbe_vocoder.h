@@ -9,6 +9,21 @@
 
 #include <cstdint>
 
+// The length of the inter-frame state saved by get_state
+const unsigned int IMBE_STATE_LENGTH = 4186U;
+
+// The most harmonics in a frame
+const unsigned int IMBE_MAX_HARMS = 56U;
+
+// One frame as a harmonic model, the fundamental in radians per sample and the
+// voicing and spectral amplitude of each harmonic, on the scale of the decoder
+struct imbe_model {
+    float w0;
+    int   num_harms;
+    bool  voiced[IMBE_MAX_HARMS];
+    float amp[IMBE_MAX_HARMS];
+};
+
 class imbe_vocoder_impl;
 class imbe_vocoder
 {
@@ -23,6 +38,22 @@ public:
     // outputs the resulting 160 audio samples (snd)
     void imbe_decode(int16_t *frame_vector, int16_t *snd);
 
+    // imbe_decode_model decodes IMBE codewords (frame_vector) to the harmonic
+    // model without synthesising any audio
+    void imbe_decode_model(int16_t *frame_vector, imbe_model *model);
+
+    // imbe_encode_model quantises a harmonic model to IMBE codewords (frame_vector)
+    // without analysing any audio
+    void imbe_encode_model(int16_t *frame_vector, const imbe_model *model);
+
+    // reset returns the encoder and decoder to their initial state
+    void reset(void);
+
+    // get_state copies the inter-frame state, IMBE_STATE_LENGTH bytes, to state
+    // and set_state loads it back, so that one vocoder can serve several streams
+    void get_state(uint8_t *state) const;
+    void set_state(const uint8_t *state);
+
 private:
     imbe_vocoder_impl *Impl;
 };
@@ -7,20 +7,27 @@
 #include <cstdio>
 
 #include "imbe_vocoder_impl.h"
+#include "imbe_vocoder.h"
 
-imbe_vocoder_impl::imbe_vocoder_impl (void) :
-	prev_pitch(0),
-	prev_prev_pitch(0),
-	prev_e_p(0),
-	prev_prev_e_p(0),
-	seed(1),
-	num_harms_prev1(0),
-	num_harms_prev2(0),
-	num_harms_prev3(0),
-	fund_freq_prev(0),
-	th_max(0),
-	dc_rmv_mem(0)
+imbe_vocoder_impl::imbe_vocoder_impl (void)
 {
+	reset();
+}
+
+void imbe_vocoder_impl::reset(void)
+{
+	prev_pitch = 0;
+	prev_prev_pitch = 0;
+	prev_e_p = 0;
+	prev_prev_e_p = 0;
+	seed = 1;
+	num_harms_prev1 = 0;
+	num_harms_prev2 = 0;
+	num_harms_prev3 = 0;
+	fund_freq_prev = 0;
+	th_max = 0;
+	dc_rmv_mem = 0;
+
 	memset(wr_array, 0, sizeof(wr_array));
 	memset(wi_array, 0, sizeof(wi_array));
 	memset(pitch_est_buf, 0, sizeof(pitch_est_buf));
@@ -40,3 +47,27 @@ imbe_vocoder_impl::imbe_vocoder_impl (void) :
 	decode_init(&my_imbe_param);
 	encode_init();
 }
+
+unsigned int imbe_vocoder_impl::get_state(uint8_t *state) const
+{
+#define IMBE_STATE_LENGTH_OF(m) sizeof(m) +
+	static_assert((IMBE_STATE_MEMBERS(IMBE_STATE_LENGTH_OF) 0U) == IMBE_STATE_LENGTH, "IMBE_STATE_LENGTH does not match the state members");
+#undef IMBE_STATE_LENGTH_OF
+
+	uint8_t *p = state;
+
+#define IMBE_STATE_GET(m) memcpy(p, &m, sizeof(m)); p += sizeof(m);
+	IMBE_STATE_MEMBERS(IMBE_STATE_GET)
+#undef IMBE_STATE_GET
+
+	return p - state;
+}
+
+void imbe_vocoder_impl::set_state(const uint8_t *state)
+{
+	const uint8_t *p = state;
+
+#define IMBE_STATE_SET(m) memcpy(&m, p, sizeof(m)); p += sizeof(m);
+	IMBE_STATE_MEMBERS(IMBE_STATE_SET)
+#undef IMBE_STATE_SET
+}
@@ -16,6 +16,14 @@
 #include "math_sub.h"
 #include "encode.h"
 #include "decode.h"
+#include "imbe_vocoder.h"
+
+// The members carried from one frame to the next, the FFT tables and buffers are rebuilt for every frame
+#define IMBE_STATE_MEMBERS(X) \
+	X(my_imbe_param) X(prev_pitch) X(prev_prev_pitch) X(prev_e_p) X(prev_prev_e_p) X(seed) \
+	X(num_harms_prev1) X(sa_prev1) X(num_harms_prev2) X(sa_prev2) X(uv_mem) X(ph_mem) \
+	X(num_harms_prev3) X(fund_freq_prev) X(vu_dsn_prev) X(sa_prev3) X(th_max) X(v_uv_dsn) \
+	X(pitch_est_buf) X(pitch_ref_buf) X(dc_rmv_mem) X(pe_lpf_mem)
 
 class imbe_vocoder_impl
 {
@@ -32,6 +40,20 @@ public:
 	void imbe_decode(int16_t *frame_vector, int16_t *snd) {
 		decode(&my_imbe_param, frame_vector, snd);
 	}
+	// imbe_decode_model decodes IMBE codewords to the harmonic model
+	void imbe_decode_model(int16_t *frame_vector, imbe_model *model) {
+		decode_model(&my_imbe_param, frame_vector, model);
+	}
+	// imbe_encode_model quantises a harmonic model to IMBE codewords
+	void imbe_encode_model(int16_t *frame_vector, const imbe_model *model) {
+		encode_model(&my_imbe_param, frame_vector, model);
+	}
+	// reset returns the encoder and decoder to their initial state
+	void reset(void);
+	// get_state copies the inter-frame state to state and returns its length,
+	// set_state loads a state previously saved by get_state
+	unsigned int get_state(uint8_t *state) const;
+	void set_state(const uint8_t *state);
 private:
 	IMBE_PARAM my_imbe_param;
 
@@ -83,7 +105,10 @@ private:
 	void v_uv_det(IMBE_PARAM *imbe_param, Cmplx16 *fft_buf);
 	void decode_init(IMBE_PARAM *imbe_param);
 	void decode(IMBE_PARAM *imbe_param, Word16 *frame_vector, Word16 *snd);
+	void decode_model(IMBE_PARAM *imbe_param, Word16 *frame_vector, imbe_model *model);
+	void encode_model(IMBE_PARAM *imbe_param, Word16 *frame_vector, const imbe_model *model);
 	void encode_init(void);
+	Word16 rand_gen(void);
 };
 
 #endif /* INCLUDED_IMBE_VOCODER_IMPL_H */
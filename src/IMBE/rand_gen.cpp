@@ -21,10 +21,7 @@
 
 
 
-#include "typedef.h"
-#include "basic_op.h"
-
-static UWord32 seed = 1;
+#include "imbe_vocoder_impl.h"
 
 
 //-----------------------------------------------------------------------------
@@ -42,7 +39,7 @@ static UWord32 seed = 1;
 //		        Pseudo-random number in signed Q1.16 format
 //
 //-----------------------------------------------------------------------------
-Word16 rand_gen(void)
+Word16 imbe_vocoder_impl::rand_gen(void)
 {
 	UWord32 hi, lo;
 
@@ -26,7 +26,6 @@
 #include "dsp_sub.h"
 #include "math_sub.h"
 #include "uv_synt.h"
-#include "rand_gen.h"
 #include "tbls.h"
 #include "encode.h"
 #include "imbe_vocoder_impl.h"
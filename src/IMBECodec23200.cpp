@@ -0,0 +1,125 @@
+/*
+ *   Copyright (C) 2026 by Jonathan Naylor G4KLX
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "IMBECodec23200.h"
+
+#include "IMBEUtils.h"
+#include "Debug.h"
+
+#include <cmath>
+
+// The gains from IMBE spectral amplitudes to Codec2 harmonic amplitudes, set so that the level
+// matches the conversion through PCM. An unvoiced IMBE amplitude is a level per unit bandwidth.
+const float VOICED_GAIN   = 0.9F;
+const float UNVOICED_GAIN = 5.0F;
+
+// Codec2 has one voicing decision for the frame, taken from the energy of the harmonics below 1 kHz
+const float VOICING_LIMIT = float(M_PI) / 4.0F;
+
+CIMBECodec23200::CIMBECodec23200() :
+CQueuedProcessor(),
+m_imbe(-1),
+m_codec2(-1)
+{
+}
+
+CIMBECodec23200::~CIMBECodec23200()
+{
+}
+
+uint8_t CIMBECodec23200::init(uint8_t n)
+{
+  m_imbe = vocoders.allocateIMBE();
+  if (m_imbe < 0)
+    return 0x07U;
+
+  m_codec2 = vocoders.allocateCodec2();
+  if (m_codec2 < 0) {
+    release();
+    return 0x07U;
+  }
+
+  return 0x00U;
+}
+
+void CIMBECodec23200::release()
+{
+  vocoders.releaseIMBE(m_imbe);
+  vocoders.releaseCodec2(m_codec2);
+  m_imbe   = -1;
+  m_codec2 = -1;
+}
+
+uint8_t CIMBECodec23200::input(const uint8_t* buffer, uint16_t length)
+{
+  if (m_queue.isFull()) {
+    DEBUG1("Codec2 3200 frame queue is full");
+    return 0x05U;
+  }
+
+  if (length != IMBE_DATA_LENGTH) {
+    DEBUG2("IMBE frame length is invalid", length);
+    return 0x04U;
+  }
+
+  uint8_t* out = m_queue.next();
+
+  int16_t frame[8U];
+  CIMBEUtils::packedToIMBE(buffer, frame);
+
+  imbe_model imbe;
+  vocoders.getIMBE(m_imbe)->imbe_decode_model(frame, &imbe);
+
+  MODEL codec2;
+  codec2.Wo = imbe.w0;
+  codec2.L  = int(float(M_PI) / imbe.w0);
+  if (codec2.L > MAX_AMP)
+    codec2.L = MAX_AMP;
+
+  float voiced = 0.0F;
+  float total  = 0.0F;
+  for (int m = 1; m <= codec2.L; m++) {
+    float amp = 0.0F;
+
+    if (m <= imbe.num_harms) {
+      if (imbe.voiced[m - 1])
+        amp = VOICED_GAIN * imbe.amp[m - 1];
+      else
+        amp = UNVOICED_GAIN * imbe.amp[m - 1] * ::sqrtf(imbe.w0);
+
+      if ((float(m) * imbe.w0) < VOICING_LIMIT) {
+        total += amp * amp;
+        if (imbe.voiced[m - 1])
+          voiced += amp * amp;
+      }
+    }
+
+    codec2.A[m]   = amp;
+    codec2.phi[m] = 0.0F;
+  }
+
+  codec2.voiced = (voiced > (0.5F * total)) ? 1 : 0;
+
+  uint32_t start = CStats::cycles();
+  vocoders.getCodec2(m_codec2)->codec2_encode_model((unsigned char*)out, &codec2);
+  stats.stage(STAGE::CODEC2_ENCODE, start);
+
+  m_queue.push();
+
+  return 0x00U;
+}
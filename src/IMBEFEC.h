@@ -19,22 +19,18 @@
 #ifndef	IMBEFEC_H
 #define	IMBEFEC_H
 
-#include "Processor.h"
+#include "QueuedProcessor.h"
 
 #include "ModeDefines.h"
 
-class CIMBEFEC : public IProcessor {
+class CIMBEFEC final : public CQueuedProcessor<IMBE_FEC_DATA_LENGTH> {
   public:
     CIMBEFEC();
     virtual ~CIMBEFEC();
 
     virtual uint8_t input(const uint8_t* buffer, uint16_t length) override;
 
-    virtual int16_t output(uint8_t* buffer) override;
-
   private:
-    uint8_t m_buffer[IMBE_FEC_DATA_LENGTH];
-    bool    m_inUse;
 };
 
 #endif
@@ -23,8 +23,7 @@
 
 
 CIMBEFECIMBE::CIMBEFECIMBE() :
-m_buffer(),
-m_inUse(false)
+CQueuedProcessor()
 {
 }
 
@@ -34,8 +33,8 @@ CIMBEFECIMBE::~CIMBEFECIMBE()
 
 uint8_t CIMBEFECIMBE::input(const uint8_t* buffer, uint16_t length)
 {
-  if (m_inUse) {
-    DEBUG1("IMBE frame is being overwritten");
+  if (m_queue.isFull()) {
+    DEBUG1("IMBE frame queue is full");
     return 0x05U;
   }
 
@@ -44,22 +43,13 @@ uint8_t CIMBEFECIMBE::input(const uint8_t* buffer, uint16_t length)
     return 0x04U;
   }
 
+  uint8_t* out = m_queue.next();
+
   int16_t frame[8U];
   CIMBEUtils::fecToIMBE(buffer, frame);
-  CIMBEUtils::imbeToPacked(frame, m_buffer);
+  CIMBEUtils::imbeToPacked(frame, out);
 
-  m_inUse = true;
+  m_queue.push();
 
   return 0x00U;
 }
-
-int16_t CIMBEFECIMBE::output(uint8_t* buffer)
-{
-  if (!m_inUse)
-    return 0;
-
-  ::memcpy(buffer, m_buffer, IMBE_DATA_LENGTH);
-  m_inUse = false;
-
-  return IMBE_DATA_LENGTH;
-}
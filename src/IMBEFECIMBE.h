@@ -19,22 +19,18 @@
 #ifndef	IMBEFECIMBE_H
 #define	IMBEFECIMBE_H
 
-#include "Processor.h"
+#include "QueuedProcessor.h"
 
 #include "ModeDefines.h"
 
-class CIMBEFECIMBE : public IProcessor {
+class CIMBEFECIMBE final : public CQueuedProcessor<IMBE_DATA_LENGTH> {
   public:
     CIMBEFECIMBE();
     virtual ~CIMBEFECIMBE();
 
     virtual uint8_t input(const uint8_t* buffer, uint16_t length) override;
 
-    virtual int16_t output(uint8_t* buffer) override;
-
   private:
-    uint8_t m_buffer[IMBE_DATA_LENGTH];
-    bool    m_inUse;
 };
 
 #endif
@@ -23,8 +23,8 @@
 
 
 CIMBEFECPCM::CIMBEFECPCM() :
-m_buffer(),
-m_inUse(false)
+CQueuedProcessor(),
+m_stream(-1)
 {
 }
 
@@ -32,10 +32,25 @@ CIMBEFECPCM::~CIMBEFECPCM()
 {
 }
 
+uint8_t CIMBEFECPCM::init(uint8_t n)
+{
+  m_stream = vocoders.allocateIMBE();
+  if (m_stream < 0)
+    return 0x07U;
+
+  return 0x00U;
+}
+
+void CIMBEFECPCM::release()
+{
+  vocoders.releaseIMBE(m_stream);
+  m_stream = -1;
+}
+
 uint8_t CIMBEFECPCM::input(const uint8_t* buffer, uint16_t length)
 {
-  if (m_inUse) {
-    DEBUG1("PCM frame is being overwritten");
+  if (m_queue.isFull()) {
+    DEBUG1("PCM frame queue is full");
     return 0x05U;
   }
 
@@ -44,23 +59,14 @@ uint8_t CIMBEFECPCM::input(const uint8_t* buffer, uint16_t length)
     return 0x04U;
   }
 
+  uint8_t* out = m_queue.next();
+
   int16_t frame[8U];
   CIMBEUtils::fecToIMBE(buffer, frame);
 
-  imbe.imbe_decode(frame, (int16_t*)m_buffer);
+  vocoders.getIMBE(m_stream)->imbe_decode(frame, (int16_t*)out);
 
-  m_inUse = true;
+  m_queue.push();
 
   return 0x00U;
 }
-
-int16_t CIMBEFECPCM::output(uint8_t* buffer)
-{
-  if (!m_inUse)
-    return 0;
-
-  ::memcpy(buffer, m_buffer, PCM_DATA_LENGTH);
-  m_inUse = false;
-
-  return PCM_DATA_LENGTH;
-}
@@ -22,8 +22,7 @@
 #include "Debug.h"
 
 CIMBEIMBEFEC::CIMBEIMBEFEC() :
-m_buffer(),
-m_inUse(false)
+CQueuedProcessor()
 {
 }
 
@@ -33,8 +32,8 @@ CIMBEIMBEFEC::~CIMBEIMBEFEC()
 
 uint8_t CIMBEIMBEFEC::input(const uint8_t* buffer, uint16_t length)
 {
-  if (m_inUse) {
-    DEBUG1("IMBE FEC frame is being overwritten");
+  if (m_queue.isFull()) {
+    DEBUG1("IMBE FEC frame queue is full");
     return 0x05U;
   }
 
@@ -43,22 +42,13 @@ uint8_t CIMBEIMBEFEC::input(const uint8_t* buffer, uint16_t length)
     return 0x04U;
   }
 
+  uint8_t* out = m_queue.next();
+
   int16_t frame[8U];
   CIMBEUtils::packedToIMBE(buffer, frame);
-  CIMBEUtils::imbeToFEC(frame, m_buffer);
+  CIMBEUtils::imbeToFEC(frame, out);
 
-  m_inUse = true;
+  m_queue.push();
 
   return 0x00U;
 }
-
-int16_t CIMBEIMBEFEC::output(uint8_t* buffer)
-{
-  if (!m_inUse)
-    return 0;
-
-  ::memcpy(buffer, m_buffer, IMBE_FEC_DATA_LENGTH);
-  m_inUse = false;
-
-  return IMBE_FEC_DATA_LENGTH;
-}
@@ -19,22 +19,18 @@
 #ifndef	IMBEIMBEFEC_H
 #define	IMBEIMBEFEC_H
 
-#include "Processor.h"
+#include "QueuedProcessor.h"
 
 #include "ModeDefines.h"
 
-class CIMBEIMBEFEC : public IProcessor {
+class CIMBEIMBEFEC final : public CQueuedProcessor<IMBE_FEC_DATA_LENGTH> {
   public:
     CIMBEIMBEFEC();
     virtual ~CIMBEIMBEFEC();
 
     virtual uint8_t input(const uint8_t* buffer, uint16_t length) override;
 
-    virtual int16_t output(uint8_t* buffer) override;
-
   private:
-    uint8_t m_buffer[IMBE_FEC_DATA_LENGTH];
-    bool    m_inUse;
 };
 
 #endif
@@ -19,22 +19,23 @@
 #ifndef	IMBEPCM_H
 #define	IMBEPCM_H
 
-#include "Processor.h"
+#include "QueuedProcessor.h"
 
 #include "ModeDefines.h"
 
-class CIMBEPCM : public IProcessor {
+class CIMBEPCM final : public CQueuedProcessor<PCM_DATA_LENGTH> {
   public:
     CIMBEPCM();
     virtual ~CIMBEPCM();
 
-    virtual uint8_t input(const uint8_t* buffer, uint16_t length) override;
+    virtual uint8_t init(uint8_t n) override;
+
+    virtual void    release() override;
 
-    virtual int16_t output(uint8_t* buffer) override;
+    virtual uint8_t input(const uint8_t* buffer, uint16_t length) override;
 
   private:
-    uint8_t m_buffer[PCM_DATA_LENGTH];
-    bool    m_inUse;
+    int8_t m_stream;
 };
 
 #endif
@@ -21,47 +21,21 @@
 
 CSerialPort     serial;
 
-CDStarFEC       dstarfec;
-CDMRNXDNFEC     dmrnxdnfec;
-CYSFDNFEC       ysfdnfec;
-CIMBEFEC        imbefec;
-
-#if AMBE_TYPE > 0
-CYSFDNPCM       ysfdnpcm;
-CDStarPCM       dstarpcm;
-CDMRNXDNPCM     dmrnxdnpcm;
-#endif
-
-CIMBEPCM        imbepcm;
-CIMBEFECPCM     imbefecpcm;
-CCodec23200PCM  codec23200pcm;
-
-#if AMBE_TYPE > 0
-CPCMYSFDN       pcmysfdn;
-CPCMDStar       pcmdstar;
-CPCMDMRNXDN     pcmdmrnxdn;
-#endif
-
-CPCMIMBE        pcmimbe;
-CPCMIMBEFEC     pcmimbefec;
-CPCMCodec23200  pcmcodec23200;
-
-CYSFDNDMRNXDN   ysfdndmrnxdn;
-CDMRNXDNYSFDN   dmrnxdnysfdn;
-
-CIMBEIMBEFEC    imbeimbefec;
-CIMBEFECIMBE    imbefecimbe;
+CStats          stats;
+CTrace          trace;
 
-CALawPCM        alawpcm;
-CPCMALaw        pcmalaw;
-CMuLawPCM       mulawpcm;
-CPCMMuLaw       pcmmulaw;
-
-imbe_vocoder    imbe;
-CCodec2         codec23200(true);
+CVocoders       vocoders;
 
 #if AMBE_TYPE == 3
-CDVSIDriver3003 dvsi;
+CDVSIDriver3003 dvsi[AMBE3003_CHIPS] = {
+  0U,
+#if AMBE3003_CHIPS > 1
+  1U,
+#endif
+#if AMBE3003_CHIPS > 2
+  2U,
+#endif
+};
 CAMBE3003Driver ambe;
 #endif
 #if AMBE_TYPE == 2
@@ -86,6 +60,8 @@ OPMODE opmode = OPMODE::NONE;
 extern "C" {
   void setup()
   {
+    stats.start();
+
     serial.start();
 
 #if defined(HAS_LEDS)
@@ -104,9 +80,13 @@ extern "C" {
 
   void loop()
   {
+    unsigned long loopStart = micros();
+
     serial.process();
 
 #if AMBE_TYPE == 1 || AMBE_TYPE == 2 || AMBE_TYPE == 3
+    ambe.service();
+
     if (opmode == OPMODE::TRANSCODING)
       ambe.process();
 #endif
@@ -119,5 +99,7 @@ extern "C" {
       start = end;
     }
 #endif
+
+    stats.loopTime(micros() - loopStart);
   }
 }
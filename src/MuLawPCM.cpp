@@ -21,8 +21,7 @@
 #include "Debug.h"
 
 CMuLawPCM::CMuLawPCM() :
-m_buffer(),
-m_inUse(false)
+CQueuedProcessor()
 {
 }
 
@@ -32,8 +31,8 @@ CMuLawPCM::~CMuLawPCM()
 
 uint8_t CMuLawPCM::input(const uint8_t* buffer, uint16_t length)
 {
-  if (m_inUse) {
-    DEBUG1("PCM frame is being overwritten");
+  if (m_queue.isFull()) {
+    DEBUG1("PCM frame queue is full");
     return 0x05U;
   }
 
@@ -42,6 +41,8 @@ uint8_t CMuLawPCM::input(const uint8_t* buffer, uint16_t length)
     return 0x04U;
   }
 
+  uint8_t* out = m_queue.next();
+
   short audio[PCM_DATA_LENGTH / sizeof(short)];
 
   const unsigned short MULAW_BIAS = 33U;
@@ -62,20 +63,9 @@ uint8_t CMuLawPCM::input(const uint8_t* buffer, uint16_t length)
     audio[i] = sign ? decoded : -decoded;
   }
 
-  ::memcpy(m_buffer, audio, PCM_DATA_LENGTH);
+  ::memcpy(out, audio, PCM_DATA_LENGTH);
 
-  m_inUse = true;
+  m_queue.push();
 
   return 0x00U;
 }
-
-int16_t CMuLawPCM::output(uint8_t* buffer)
-{
-  if (!m_inUse)
-    return 0;
-
-  ::memcpy(buffer, m_buffer, PCM_DATA_LENGTH);
-  m_inUse = false;
-
-  return PCM_DATA_LENGTH;
-}
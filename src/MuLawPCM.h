@@ -19,22 +19,18 @@
 #ifndef	MULAWPCM_H
 #define	MULAWPCM_H
 
-#include "Processor.h"
+#include "QueuedProcessor.h"
 
 #include "ModeDefines.h"
 
-class CMuLawPCM : public IProcessor {
+class CMuLawPCM final : public CQueuedProcessor<PCM_DATA_LENGTH> {
   public:
     CMuLawPCM();
     virtual ~CMuLawPCM();
 
     virtual uint8_t input(const uint8_t* buffer, uint16_t length) override;
 
-    virtual int16_t output(uint8_t* buffer) override;
-
   private:
-    uint8_t m_buffer[PCM_DATA_LENGTH];
-    bool    m_inUse;
 };
 
 #endif
@@ -21,8 +21,7 @@
 #include "Debug.h"
 
 CPCMALaw::CPCMALaw() :
-m_buffer(),
-m_inUse(false)
+CQueuedProcessor()
 {
 }
 
@@ -32,8 +31,8 @@ CPCMALaw::~CPCMALaw()
 
 uint8_t CPCMALaw::input(const uint8_t* buffer, uint16_t length)
 {
-  if (m_inUse) {
-    DEBUG1("A-Law frame is being overwritten");
+  if (m_queue.isFull()) {
+    DEBUG1("A-Law frame queue is full");
     return 0x05U;
   }
 
@@ -42,6 +41,8 @@ uint8_t CPCMALaw::input(const uint8_t* buffer, uint16_t length)
     return 0x04U;
   }
 
+  uint8_t* out = m_queue.next();
+
   int16_t audio[PCM_DATA_LENGTH / sizeof(short)];
   ::memcpy(audio, buffer, PCM_DATA_LENGTH);
 
@@ -64,21 +65,10 @@ uint8_t CPCMALaw::input(const uint8_t* buffer, uint16_t length)
 
     eee <<= 4;
 
-    m_buffer[i] = (sign | eee | abcd) ^ 0xD5U;
+    out[i] = (sign | eee | abcd) ^ 0xD5U;
   }
 
-  m_inUse = true;
+  m_queue.push();
 
   return 0x00U;
 }
-
-int16_t CPCMALaw::output(uint8_t* buffer)
-{
-  if (!m_inUse)
-    return 0;
-
-  ::memcpy(buffer, m_buffer, ALAW_DATA_LENGTH);
-  m_inUse = false;
-
-  return ALAW_DATA_LENGTH;
-}
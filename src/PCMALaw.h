@@ -19,22 +19,18 @@
 #ifndef	PCMALAW_H
 #define	PCMALAW_H
 
-#include "Processor.h"
+#include "QueuedProcessor.h"
 
 #include "ModeDefines.h"
 
-class CPCMALaw : public IProcessor {
+class CPCMALaw final : public CQueuedProcessor<ALAW_DATA_LENGTH> {
   public:
     CPCMALaw();
     virtual ~CPCMALaw();
 
     virtual uint8_t input(const uint8_t* buffer, uint16_t length) override;
 
-    virtual int16_t output(uint8_t* buffer) override;
-
   private:
-    uint8_t m_buffer[ALAW_DATA_LENGTH];
-    bool    m_inUse;
 };
 
 #endif
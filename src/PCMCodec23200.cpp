@@ -21,8 +21,8 @@
 #include "Debug.h"
 
 CPCMCodec23200::CPCMCodec23200() :
-m_buffer(),
-m_inUse(false)
+CQueuedProcessor(),
+m_stream(-1)
 {
 }
 
@@ -30,10 +30,25 @@ CPCMCodec23200::~CPCMCodec23200()
 {
 }
 
+uint8_t CPCMCodec23200::init(uint8_t n)
+{
+  m_stream = vocoders.allocateCodec2();
+  if (m_stream < 0)
+    return 0x07U;
+
+  return 0x00U;
+}
+
+void CPCMCodec23200::release()
+{
+  vocoders.releaseCodec2(m_stream);
+  m_stream = -1;
+}
+
 uint8_t CPCMCodec23200::input(const uint8_t* buffer, uint16_t length)
 {
-  if (m_inUse) {
-    DEBUG1("Codec2 3200 frame is being overwritten");
+  if (m_queue.isFull()) {
+    DEBUG1("Codec2 3200 frame queue is full");
     return 0x05U;
   }
 
@@ -42,26 +57,19 @@ uint8_t CPCMCodec23200::input(const uint8_t* buffer, uint16_t length)
     return 0x04U;
   }
 
+  uint8_t* out = m_queue.next();
+
   short audio[PCM_DATA_LENGTH / sizeof(short)];
   ::memcpy(audio, buffer, PCM_DATA_LENGTH);
 
   for (uint16_t i = 0U; i < (PCM_DATA_LENGTH / sizeof(short)); i++)
     audio[i] *= 8;
 
-  codec23200.codec2_encode((unsigned char*)m_buffer, audio);
+  uint32_t start = CStats::cycles();
+  vocoders.getCodec2(m_stream)->codec2_encode((unsigned char*)out, audio);
+  stats.stage(STAGE::CODEC2_ENCODE, start);
 
-  m_inUse = true;
+  m_queue.push();
 
   return 0x00U;
 }
-
-int16_t CPCMCodec23200::output(uint8_t* buffer)
-{
-  if (!m_inUse)
-    return 0;
-
-  ::memcpy(buffer, m_buffer, CODEC2_3200_DATA_LENGTH);
-  m_inUse = false;
-
-  return CODEC2_3200_DATA_LENGTH;
-}
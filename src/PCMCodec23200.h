@@ -19,22 +19,23 @@
 #ifndef	PCMCodec23200_H
 #define	PCMCodec23200_H
 
-#include "Processor.h"
+#include "QueuedProcessor.h"
 
 #include "ModeDefines.h"
 
-class CPCMCodec23200 : public IProcessor {
+class CPCMCodec23200 final : public CQueuedProcessor<CODEC2_3200_DATA_LENGTH> {
   public:
     CPCMCodec23200();
     virtual ~CPCMCodec23200();
 
-    virtual uint8_t input(const uint8_t* buffer, uint16_t length) override;
+    virtual uint8_t init(uint8_t n) override;
+
+    virtual void    release() override;
 
-    virtual int16_t output(uint8_t* buffer) override;
+    virtual uint8_t input(const uint8_t* buffer, uint16_t length) override;
 
   private:
-    uint8_t m_buffer[CODEC2_3200_DATA_LENGTH];
-    bool    m_inUse;
+    int8_t m_stream;
 };
 
 #endif
@@ -37,9 +37,7 @@ uint8_t CPCMDMRNXDN::init(uint8_t n)
 {
   m_n = n;
 
-  ambe.init(m_n, AMBE_MODE::PCM_TO_DMR_NXDN);
-
-  return 0x00U;
+  return ambe.init(m_n, AMBE_MODE::PCM_TO_DMR_NXDN);
 }
 
 uint8_t CPCMDMRNXDN::input(const uint8_t* buffer, uint16_t length)
@@ -68,4 +66,14 @@ int16_t CPCMDMRNXDN::output(uint8_t* buffer)
   }
 }
 
+void CPCMDMRNXDN::flush()
+{
+  ambe.drain(m_n);
+}
+
+uint8_t CPCMDMRNXDN::space() const
+{
+  return ambe.space(m_n);
+}
+
 #endif
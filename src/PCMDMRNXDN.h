@@ -25,7 +25,7 @@
 
 #include "Processor.h"
 
-class CPCMDMRNXDN : public IProcessor {
+class CPCMDMRNXDN final : public IProcessor {
   public:
     CPCMDMRNXDN();
     virtual ~CPCMDMRNXDN();
@@ -36,6 +36,10 @@ class CPCMDMRNXDN : public IProcessor {
 
     virtual int16_t output(uint8_t* buffer) override;
 
+    virtual void    flush() override;
+
+    virtual uint8_t space() const override;
+
   private:
     uint8_t m_n;
 };
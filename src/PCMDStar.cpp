@@ -37,9 +37,7 @@ uint8_t CPCMDStar::init(uint8_t n)
 {
   m_n = n;
 
-  ambe.init(m_n, AMBE_MODE::PCM_TO_DSTAR);
-
-  return 0x00U;
+  return ambe.init(m_n, AMBE_MODE::PCM_TO_DSTAR);
 }
 
 uint8_t CPCMDStar::input(const uint8_t* buffer, uint16_t length)
@@ -68,4 +66,14 @@ int16_t CPCMDStar::output(uint8_t* buffer)
   }
 }
 
+void CPCMDStar::flush()
+{
+  ambe.drain(m_n);
+}
+
+uint8_t CPCMDStar::space() const
+{
+  return ambe.space(m_n);
+}
+
 #endif
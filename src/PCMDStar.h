@@ -25,7 +25,7 @@
 
 #include "Processor.h"
 
-class CPCMDStar : public IProcessor {
+class CPCMDStar final : public IProcessor {
   public:
     CPCMDStar();
     virtual ~CPCMDStar();
@@ -36,6 +36,10 @@ class CPCMDStar : public IProcessor {
 
     virtual int16_t output(uint8_t* buffer) override;
 
+    virtual void    flush() override;
+
+    virtual uint8_t space() const override;
+
   private:
     uint8_t m_n;
 };
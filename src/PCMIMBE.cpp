@@ -22,8 +22,8 @@
 #include "Debug.h"
 
 CPCMIMBE::CPCMIMBE() :
-m_buffer(),
-m_inUse(false)
+CQueuedProcessor(),
+m_stream(-1)
 {
 }
 
@@ -31,10 +31,25 @@ CPCMIMBE::~CPCMIMBE()
 {
 }
 
+uint8_t CPCMIMBE::init(uint8_t n)
+{
+  m_stream = vocoders.allocateIMBE();
+  if (m_stream < 0)
+    return 0x07U;
+
+  return 0x00U;
+}
+
+void CPCMIMBE::release()
+{
+  vocoders.releaseIMBE(m_stream);
+  m_stream = -1;
+}
+
 uint8_t CPCMIMBE::input(const uint8_t* buffer, uint16_t length)
 {
-  if (m_inUse) {
-    DEBUG1("IMBE frame is being overwritten");
+  if (m_queue.isFull()) {
+    DEBUG1("IMBE frame queue is full");
     return 0x05U;
   }
 
@@ -43,23 +58,16 @@ uint8_t CPCMIMBE::input(const uint8_t* buffer, uint16_t length)
     return 0x04U;
   }
 
+  uint8_t* out = m_queue.next();
+
   int16_t frame[8U];
-  imbe.imbe_encode(frame, (int16_t*)buffer);
+  uint32_t start = CStats::cycles();
+  vocoders.getIMBE(m_stream)->imbe_encode(frame, (int16_t*)buffer);
+  stats.stage(STAGE::IMBE_ENCODE, start);
 
-  CIMBEUtils::imbeToPacked(frame, m_buffer);
+  CIMBEUtils::imbeToPacked(frame, out);
 
-  m_inUse = true;
+  m_queue.push();
 
   return 0x00U;
 }
-
-int16_t CPCMIMBE::output(uint8_t* buffer)
-{
-  if (!m_inUse)
-    return 0;
-
-  ::memcpy(buffer, m_buffer, IMBE_DATA_LENGTH);
-  m_inUse = false;
-
-  return IMBE_DATA_LENGTH;
-}
@@ -19,21 +19,23 @@
 #ifndef	PCMIMBEFEC_H
 #define	PCMIMBEFEC_H
 
-#include "Processor.h"
+#include "QueuedProcessor.h"
 
 #include "ModeDefines.h"
 
-class CPCMIMBEFEC : public IProcessor {
+class CPCMIMBEFEC final : public CQueuedProcessor<IMBE_FEC_DATA_LENGTH> {
   public:
     CPCMIMBEFEC();
     virtual ~CPCMIMBEFEC();
 
-    virtual uint8_t input(const uint8_t* buffer, uint16_t length) override;
+    virtual uint8_t init(uint8_t n) override;
+
+    virtual void    release() override;
 
-    virtual int16_t output(uint8_t* buffer) override;
+    virtual uint8_t input(const uint8_t* buffer, uint16_t length) override;
 
   private:
-    uint8_t m_buffer[IMBE_FEC_DATA_LENGTH];
-    bool    m_inUse;};
+    int8_t m_stream;
+};
 
 #endif
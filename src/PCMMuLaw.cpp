@@ -21,8 +21,7 @@
 #include "Debug.h"
 
 CPCMMuLaw::CPCMMuLaw() :
-m_buffer(),
-m_inUse(false)
+CQueuedProcessor()
 {
 }
 
@@ -32,8 +31,8 @@ CPCMMuLaw::~CPCMMuLaw()
 
 uint8_t CPCMMuLaw::input(const uint8_t* buffer, uint16_t length)
 {
-  if (m_inUse) {
-    DEBUG1("Mu-Law frame is being overwritten");
+  if (m_queue.isFull()) {
+    DEBUG1("Mu-Law frame queue is full");
     return 0x05U;
   }
 
@@ -42,6 +41,8 @@ uint8_t CPCMMuLaw::input(const uint8_t* buffer, uint16_t length)
     return 0x04U;
   }
 
+  uint8_t* out = m_queue.next();
+
   short audio[PCM_DATA_LENGTH / sizeof(short)];
   ::memcpy(audio, buffer, PCM_DATA_LENGTH);
 
@@ -71,21 +72,10 @@ uint8_t CPCMMuLaw::input(const uint8_t* buffer, uint16_t length)
 
 		unsigned char lsb = (number >> (position - 4U)) & 0x0FU;
 
-		m_buffer[i] = ~(sign | ((position - 5U) << 4) | lsb);
+		out[i] = ~(sign | ((position - 5U) << 4) | lsb);
 	}
 
-  m_inUse = true;
+  m_queue.push();
 
   return 0x00U;
 }
-
-int16_t CPCMMuLaw::output(uint8_t* buffer)
-{
-  if (!m_inUse)
-    return 0;
-
-  ::memcpy(buffer, m_buffer, MULAW_DATA_LENGTH);
-  m_inUse = false;
-
-  return MULAW_DATA_LENGTH;
-}
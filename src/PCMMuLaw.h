@@ -19,22 +19,18 @@
 #ifndef	PCMMULAW_H
 #define	PCMMULAW_H
 
-#include "Processor.h"
+#include "QueuedProcessor.h"
 
 #include "ModeDefines.h"
 
-class CPCMMuLaw : public IProcessor {
+class CPCMMuLaw final : public CQueuedProcessor<MULAW_DATA_LENGTH> {
   public:
     CPCMMuLaw();
     virtual ~CPCMMuLaw();
 
     virtual uint8_t input(const uint8_t* buffer, uint16_t length) override;
 
-    virtual int16_t output(uint8_t* buffer) override;
-
   private:
-    uint8_t m_buffer[MULAW_DATA_LENGTH];
-    bool    m_inUse;
 };
 
 #endif
@@ -38,9 +38,7 @@ uint8_t CPCMYSFDN::init(uint8_t n)
 {
   m_n = n;
 
-  ambe.init(m_n, AMBE_MODE::PCM_TO_YSFDN);
-
-  return 0x00U;
+  return ambe.init(m_n, AMBE_MODE::PCM_TO_YSFDN);
 }
 
 uint8_t CPCMYSFDN::input(const uint8_t* buffer, uint16_t length)
@@ -71,4 +69,14 @@ int16_t CPCMYSFDN::output(uint8_t* buffer)
   }
 }
 
+void CPCMYSFDN::flush()
+{
+  ambe.drain(m_n);
+}
+
+uint8_t CPCMYSFDN::space() const
+{
+  return ambe.space(m_n);
+}
+
 #endif
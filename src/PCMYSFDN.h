@@ -25,7 +25,7 @@
 
 #include "Processor.h"
 
-class CPCMYSFDN : public IProcessor {
+class CPCMYSFDN final : public IProcessor {
   public:
     CPCMYSFDN();
     virtual ~CPCMYSFDN();
@@ -36,6 +36,10 @@ class CPCMYSFDN : public IProcessor {
 
     virtual int16_t output(uint8_t* buffer) override;
 
+    virtual void    flush() override;
+
+    virtual uint8_t space() const override;
+
   private:
     uint8_t m_n;
 };
@@ -26,3 +26,22 @@ uint8_t IProcessor::init(uint8_t n)
 {
   return 0x00U;
 }
+
+void IProcessor::release()
+{
+}
+
+int16_t IProcessor::peek(uint8_t* scratch, const uint8_t*& frame)
+{
+  frame = scratch;
+
+  return output(scratch);
+}
+
+void IProcessor::discard()
+{
+}
+
+void IProcessor::flush()
+{
+}
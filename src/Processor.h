@@ -27,10 +27,25 @@ class IProcessor {
 
     virtual uint8_t init(uint8_t n);
 
+    // Give back anything taken by init
+    virtual void    release();
+
     virtual uint8_t input(const uint8_t* buffer, uint16_t length) = 0;
 
     virtual int16_t output(uint8_t* buffer) = 0;
 
+    // The next output frame where it is held, without copying it out, then discard() drops it. A
+    // processor that holds no frames of its own outputs into the scratch buffer instead.
+    virtual int16_t peek(uint8_t* scratch, const uint8_t*& frame);
+
+    virtual void    discard();
+
+    // Drop every frame held, including any still inside an AMBE chip
+    virtual void    flush();
+
+    // The number of frames that can be input before the processor is full
+    virtual uint8_t space() const = 0;
+
   private:
 };
 
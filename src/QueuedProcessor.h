@@ -0,0 +1,76 @@
+/*
+ *   Copyright (C) 2026 by Jonathan Naylor G4KLX
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef	QueuedProcessor_H
+#define	QueuedProcessor_H
+
+#include "Processor.h"
+#include "FrameQueue.h"
+
+#include <cstdint>
+
+// A processor whose output frames, all of LENGTH bytes, wait in a queue. The next stage
+// reads each frame where it is held with peek() and then drops it with discard().
+template <uint16_t LENGTH>
+class CQueuedProcessor : public IProcessor {
+  public:
+    CQueuedProcessor() :
+    m_queue()
+    {
+    }
+
+    virtual int16_t output(uint8_t* buffer) override
+    {
+      if (m_queue.isEmpty())
+        return 0;
+
+      m_queue.pop(buffer);
+
+      return LENGTH;
+    }
+
+    virtual int16_t peek(uint8_t* scratch, const uint8_t*& frame) override
+    {
+      if (m_queue.isEmpty())
+        return 0;
+
+      frame = m_queue.peek();
+
+      return LENGTH;
+    }
+
+    virtual void    discard() override
+    {
+      m_queue.discard();
+    }
+
+    virtual void    flush() override
+    {
+      m_queue.reset();
+    }
+
+    virtual uint8_t space() const override
+    {
+      return m_queue.space();
+    }
+
+  protected:
+    CFrameQueue<LENGTH> m_queue;
+};
+
+#endif
@@ -0,0 +1,236 @@
+/*
+ *   Copyright (C) 2026 by Jonathan Naylor G4KLX
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "Routes.h"
+
+#include "ModeDefines.h"
+
+#if AMBE_TYPE == 3
+const uint8_t AMBE_STAGES = 3U;
+#elif AMBE_TYPE == 2
+const uint8_t AMBE_STAGES = 2U;
+#elif AMBE_TYPE == 1
+const uint8_t AMBE_STAGES = 1U;
+#else
+const uint8_t AMBE_STAGES = 0U;
+#endif
+
+// The unit conversions that routes are built from. Regenerating the FEC or
+// rearranging bits is cheap, mu-law and A-law are a table look up, and the
+// vocoders, in software or in the DVSI chip, are the most expensive by far.
+// Converting between the models of two vocoders costs about as much as one.
+const uint8_t COST_BITS    = 1U;
+const uint8_t COST_LAW     = 2U;
+const uint8_t COST_VOCODER = 8U;
+
+struct PRIMITIVE {
+  PROCESSOR m_type;
+  uint8_t   m_input;
+  uint8_t   m_output;
+  bool      m_corrected;    // Only takes input that has been through its FEC processor
+  uint8_t   m_cost;
+};
+
+constexpr PRIMITIVE PRIMITIVES[] = {
+  {PROCESSOR::DSTAR_FEC,       MODE_DSTAR,       MODE_DSTAR,       false, COST_BITS},
+  {PROCESSOR::DMR_NXDN_FEC,    MODE_DMR_NXDN,    MODE_DMR_NXDN,    false, COST_BITS},
+  {PROCESSOR::YSFDN_FEC,       MODE_YSFDN,       MODE_YSFDN,       false, COST_BITS},
+  {PROCESSOR::IMBE_FEC,        MODE_IMBE_FEC,    MODE_IMBE_FEC,    false, COST_BITS},
+
+  {PROCESSOR::YSFDN_DMR_NXDN,  MODE_YSFDN,       MODE_DMR_NXDN,    true,  COST_BITS},
+  {PROCESSOR::DMR_NXDN_YSFDN,  MODE_DMR_NXDN,    MODE_YSFDN,       true,  COST_BITS},
+  {PROCESSOR::IMBE_IMBE_FEC,   MODE_IMBE,        MODE_IMBE_FEC,    false, COST_BITS},
+  {PROCESSOR::IMBE_FEC_IMBE,   MODE_IMBE_FEC,    MODE_IMBE,        false, COST_BITS},
+
+  {PROCESSOR::ALAW_PCM,        MODE_ALAW,        MODE_PCM,         false, COST_LAW},
+  {PROCESSOR::MULAW_PCM,       MODE_MULAW,       MODE_PCM,         false, COST_LAW},
+  {PROCESSOR::PCM_ALAW,        MODE_PCM,         MODE_ALAW,        false, COST_LAW},
+  {PROCESSOR::PCM_MULAW,       MODE_PCM,         MODE_MULAW,       false, COST_LAW},
+
+#if AMBE_TYPE > 0
+  {PROCESSOR::DSTAR_PCM,       MODE_DSTAR,       MODE_PCM,         false, COST_VOCODER},
+  {PROCESSOR::DMR_NXDN_PCM,    MODE_DMR_NXDN,    MODE_PCM,         false, COST_VOCODER},
+  {PROCESSOR::YSFDN_PCM,       MODE_YSFDN,       MODE_PCM,         false, COST_VOCODER},
+  {PROCESSOR::PCM_DSTAR,       MODE_PCM,         MODE_DSTAR,       false, COST_VOCODER},
+  {PROCESSOR::PCM_DMR_NXDN,    MODE_PCM,         MODE_DMR_NXDN,    false, COST_VOCODER},
+  {PROCESSOR::PCM_YSFDN,       MODE_PCM,         MODE_YSFDN,       false, COST_VOCODER},
+#endif
+
+  {PROCESSOR::IMBE_PCM,        MODE_IMBE,        MODE_PCM,         false, COST_VOCODER},
+  {PROCESSOR::IMBE_FEC_PCM,    MODE_IMBE_FEC,    MODE_PCM,         false, COST_VOCODER},
+  {PROCESSOR::CODEC2_3200_PCM, MODE_CODEC2_3200, MODE_PCM,         false, COST_VOCODER},
+  {PROCESSOR::PCM_IMBE,        MODE_PCM,         MODE_IMBE,        false, COST_VOCODER},
+  {PROCESSOR::PCM_IMBE_FEC,    MODE_PCM,         MODE_IMBE_FEC,    false, COST_VOCODER},
+  {PROCESSOR::PCM_CODEC2_3200, MODE_PCM,         MODE_CODEC2_3200, false, COST_VOCODER},
+
+#if defined(MODEL_TRANSCODING)
+  {PROCESSOR::IMBE_CODEC2_3200, MODE_IMBE,        MODE_CODEC2_3200, false, COST_VOCODER},
+  {PROCESSOR::CODEC2_3200_IMBE, MODE_CODEC2_3200, MODE_IMBE,        false, COST_VOCODER}
+#endif
+};
+
+constexpr uint8_t PRIMITIVES_LENGTH = sizeof(PRIMITIVES) / sizeof(PRIMITIVES[0U]);
+
+constexpr uint8_t MODES[] = {
+  MODE_DSTAR, MODE_DMR_NXDN, MODE_YSFDN, MODE_IMBE, MODE_IMBE_FEC, MODE_CODEC2_3200, MODE_ALAW, MODE_MULAW, MODE_PCM
+};
+
+constexpr uint8_t MODES_LENGTH = sizeof(MODES) / sizeof(MODES[0U]);
+
+constexpr uint8_t modeIndex(uint8_t mode)
+{
+  for (uint8_t i = 0U; i < MODES_LENGTH; i++) {
+    if (MODES[i] == mode)
+      return i;
+  }
+
+  return MODES_LENGTH;
+}
+
+// A mode with its own FEC processor is always passed through it, even when it is not converted
+constexpr bool hasFEC(uint8_t mode)
+{
+  for (uint8_t i = 0U; i < PRIMITIVES_LENGTH; i++) {
+    if ((PRIMITIVES[i].m_input == mode) && (PRIMITIVES[i].m_output == mode))
+      return true;
+  }
+
+  return false;
+}
+
+// A point in the search: a mode, whether its FEC has been checked, and the AMBE channels used to get there
+constexpr uint8_t STATES = MODES_LENGTH * 2U * (AMBE_STAGES + 1U);
+
+constexpr uint8_t stateIndex(uint8_t mode, bool corrected, uint8_t ambe)
+{
+  return (((mode * 2U) + (corrected ? 1U : 0U)) * (AMBE_STAGES + 1U)) + ambe;
+}
+
+struct ROUTE_TABLE {
+  ROUTE m_routes[MODES_LENGTH][MODES_LENGTH];
+};
+
+// Bellman-Ford over the search states from each input mode, keeping the whole route to each state
+constexpr ROUTE_TABLE buildRoutes()
+{
+  ROUTE_TABLE table = {};
+
+  for (uint8_t input = 0U; input < MODES_LENGTH; input++) {
+    uint16_t cost[STATES] = {};
+    ROUTE    route[STATES] = {};
+
+    route[stateIndex(input, false, 0U)].m_valid = true;
+
+    for (uint8_t pass = 0U; pass < MAX_STAGES; pass++) {
+      for (uint8_t mode = 0U; mode < MODES_LENGTH; mode++) {
+        for (uint8_t corrected = 0U; corrected < 2U; corrected++) {
+          for (uint8_t ambe = 0U; ambe <= AMBE_STAGES; ambe++) {
+            const uint8_t from = stateIndex(mode, corrected == 1U, ambe);
+            if (!route[from].m_valid || (route[from].m_stages >= MAX_STAGES))
+              continue;
+
+            for (uint8_t i = 0U; i < PRIMITIVES_LENGTH; i++) {
+              const PRIMITIVE& p = PRIMITIVES[i];
+              if ((modeIndex(p.m_input) != mode) || (p.m_corrected && (corrected == 0U)))
+                continue;
+
+              const uint8_t channels = ambe + (usesAMBE(p.m_type) ? 1U : 0U);
+              if (channels > AMBE_STAGES)
+                continue;
+
+              const uint8_t  to    = stateIndex(modeIndex(p.m_output), true, channels);
+              const uint16_t total = cost[from] + p.m_cost;
+              if (route[to].m_valid && (cost[to] <= total))
+                continue;
+
+              cost[to]  = total;
+              route[to] = route[from];
+              route[to].m_stage[route[to].m_stages++] = p.m_type;
+            }
+          }
+        }
+      }
+    }
+
+    for (uint8_t output = 0U; output < MODES_LENGTH; output++) {
+      uint16_t best = 0xFFFFU;
+
+      for (uint8_t corrected = 0U; corrected < 2U; corrected++) {
+        if ((corrected == 0U) && hasFEC(MODES[output]))
+          continue;
+
+        for (uint8_t ambe = 0U; ambe <= AMBE_STAGES; ambe++) {
+          const uint8_t n = stateIndex(output, corrected == 1U, ambe);
+          if (route[n].m_valid && (cost[n] < best)) {
+            best = cost[n];
+            table.m_routes[input][output] = route[n];
+          }
+        }
+      }
+    }
+  }
+
+  return table;
+}
+
+constexpr bool primitivesValid()
+{
+  for (uint8_t i = 0U; i < PRIMITIVES_LENGTH; i++) {
+    if ((modeIndex(PRIMITIVES[i].m_input) == MODES_LENGTH) || (modeIndex(PRIMITIVES[i].m_output) == MODES_LENGTH))
+      return false;
+    if (PRIMITIVES[i].m_type == PROCESSOR::NONE)
+      return false;
+  }
+
+  return true;
+}
+
+constexpr ROUTE_TABLE ROUTES = buildRoutes();
+
+constexpr bool routesValid()
+{
+  for (uint8_t i = 0U; i < MODES_LENGTH; i++) {
+    // Every mode can be passed straight through, at most via its FEC processor
+    if (!ROUTES.m_routes[i][i].m_valid || (ROUTES.m_routes[i][i].m_stages > 1U))
+      return false;
+
+    // Fan-out outputs are a single processor, so encoding from PCM must take one step
+    const ROUTE& encode = ROUTES.m_routes[modeIndex(MODE_PCM)][i];
+    if (encode.m_valid && (encode.m_stages > 1U))
+      return false;
+  }
+
+  return true;
+}
+
+static_assert(primitivesValid(), "A processing primitive uses an unknown mode");
+static_assert(routesValid(), "The processing routes are not as expected");
+
+const ROUTE* findRoute(uint8_t input, uint8_t output)
+{
+  uint8_t i = modeIndex(input);
+  uint8_t o = modeIndex(output);
+  if ((i == MODES_LENGTH) || (o == MODES_LENGTH))
+    return nullptr;
+
+  const ROUTE& route = ROUTES.m_routes[i][o];
+  if (!route.m_valid)
+    return nullptr;
+
+  return &route;
+}
@@ -0,0 +1,85 @@
+/*
+ *   Copyright (C) 2026 by Jonathan Naylor G4KLX
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef	Routes_H
+#define	Routes_H
+
+#include "Config.h"
+
+#include <cstdint>
+
+enum class PROCESSOR : uint8_t {
+  NONE,
+  DSTAR_FEC,
+  DMR_NXDN_FEC,
+  YSFDN_FEC,
+  IMBE_FEC,
+  DSTAR_PCM,
+  DMR_NXDN_PCM,
+  YSFDN_PCM,
+  IMBE_PCM,
+  IMBE_FEC_PCM,
+  CODEC2_3200_PCM,
+  ALAW_PCM,
+  MULAW_PCM,
+  PCM_DSTAR,
+  PCM_DMR_NXDN,
+  PCM_YSFDN,
+  PCM_IMBE,
+  PCM_IMBE_FEC,
+  PCM_CODEC2_3200,
+  PCM_ALAW,
+  PCM_MULAW,
+  YSFDN_DMR_NXDN,
+  DMR_NXDN_YSFDN,
+  IMBE_IMBE_FEC,
+  IMBE_FEC_IMBE,
+  IMBE_CODEC2_3200,
+  CODEC2_3200_IMBE
+};
+
+// The most processing stages that a session can chain together
+const uint8_t MAX_STAGES = 4U;
+
+// The chain of processors that converts one mode to another, no stages for an identity session
+struct ROUTE {
+  bool      m_valid;
+  uint8_t   m_stages;
+  PROCESSOR m_stage[MAX_STAGES];
+};
+
+// True for the processors that need a DVSI vocoder channel
+constexpr bool usesAMBE(PROCESSOR type)
+{
+  return (type == PROCESSOR::DSTAR_PCM) || (type == PROCESSOR::DMR_NXDN_PCM) || (type == PROCESSOR::YSFDN_PCM) ||
+         (type == PROCESSOR::PCM_DSTAR) || (type == PROCESSOR::PCM_DMR_NXDN) || (type == PROCESSOR::PCM_YSFDN);
+}
+
+// True for the processors that run a hardware or software vocoder
+constexpr bool usesVocoder(PROCESSOR type)
+{
+  return usesAMBE(type) ||
+         (type == PROCESSOR::IMBE_PCM) || (type == PROCESSOR::IMBE_FEC_PCM) || (type == PROCESSOR::CODEC2_3200_PCM) ||
+         (type == PROCESSOR::PCM_IMBE) || (type == PROCESSOR::PCM_IMBE_FEC) || (type == PROCESSOR::PCM_CODEC2_3200) ||
+         (type == PROCESSOR::IMBE_CODEC2_3200) || (type == PROCESSOR::CODEC2_3200_IMBE);
+}
+
+// The cheapest route from the input to the output mode, nullptr if they cannot be converted
+const ROUTE* findRoute(uint8_t input, uint8_t output);
+
+#endif
@@ -23,129 +23,6 @@
 #include "SerialPort.h"
 #include "Version.h"
 
-const struct {
-  uint8_t     m_input;
-  uint8_t     m_output;
-  IProcessor* m_step1;
-  IProcessor* m_step2;
-} PROCESSOR_TABLE[] = {
-#if AMBE_TYPE > 0
-#if AMBE_TYPE > 1
-  {MODE_DSTAR,        MODE_DMR_NXDN,      &dstarpcm,       &pcmdmrnxdn},
-  {MODE_DSTAR,        MODE_YSFDN,         &dstarpcm,       &pcmysfdn},
-#endif
-  {MODE_DSTAR,        MODE_IMBE,          &dstarpcm,       &pcmimbe},
-  {MODE_DSTAR,        MODE_IMBE_FEC,      &dstarpcm,       &pcmimbefec},
-  {MODE_DSTAR,        MODE_CODEC2_3200,   &dstarpcm,       &pcmcodec23200},
-  {MODE_DSTAR,        MODE_ALAW,          &dstarpcm,       &pcmalaw},
-  {MODE_DSTAR,        MODE_MULAW,         &dstarpcm,       &pcmmulaw},
-  {MODE_DSTAR,        MODE_PCM,           &dstarpcm,       nullptr},
-#endif
-  {MODE_DSTAR,        MODE_DSTAR,         &dstarfec,       nullptr},
-
-#if AMBE_TYPE > 0
-#if AMBE_TYPE > 1
-  {MODE_DMR_NXDN,     MODE_DSTAR,         &dmrnxdnpcm,     &pcmdstar},
-#endif
-  {MODE_DMR_NXDN,     MODE_IMBE,          &dmrnxdnpcm,     &pcmimbe},
-  {MODE_DMR_NXDN,     MODE_IMBE_FEC,      &dmrnxdnpcm,     &pcmimbefec},
-  {MODE_DMR_NXDN,     MODE_CODEC2_3200,   &dmrnxdnpcm,     &pcmcodec23200},
-  {MODE_DMR_NXDN,     MODE_ALAW,          &dmrnxdnpcm,     &pcmalaw},
-  {MODE_DMR_NXDN,     MODE_MULAW,         &dmrnxdnpcm,     &pcmmulaw},
-  {MODE_DMR_NXDN,     MODE_PCM,           &dmrnxdnpcm,     nullptr},
-#endif
-  {MODE_DMR_NXDN,     MODE_DMR_NXDN,      &dmrnxdnfec,     nullptr},
-  {MODE_DMR_NXDN,     MODE_YSFDN,         &dmrnxdnfec,     &dmrnxdnysfdn},
-
-#if AMBE_TYPE > 0
-#if AMBE_TYPE > 1
-  {MODE_YSFDN,        MODE_DSTAR,         &ysfdnpcm,       &pcmdstar},
-#endif
-  {MODE_YSFDN,        MODE_IMBE,          &ysfdnpcm,       &pcmimbe},
-  {MODE_YSFDN,        MODE_IMBE_FEC,      &ysfdnpcm,       &pcmimbefec},
-  {MODE_YSFDN,        MODE_CODEC2_3200,   &ysfdnpcm,       &pcmcodec23200},
-  {MODE_YSFDN,        MODE_ALAW,          &ysfdnpcm,       &pcmalaw},
-  {MODE_YSFDN,        MODE_MULAW,         &ysfdnpcm,       &pcmmulaw},
-  {MODE_YSFDN,        MODE_PCM,           &ysfdnpcm,       nullptr},
-#endif
-  {MODE_YSFDN,        MODE_DMR_NXDN,      &ysfdnfec,       &ysfdndmrnxdn},
-  {MODE_YSFDN,        MODE_YSFDN,         &ysfdnfec,       nullptr},
-
-#if AMBE_TYPE > 0
-  {MODE_IMBE,         MODE_DSTAR,         &imbepcm,        &pcmdstar},
-  {MODE_IMBE,         MODE_DMR_NXDN,      &imbepcm,        &pcmdmrnxdn},
-  {MODE_IMBE,         MODE_YSFDN,         &imbepcm,        &pcmysfdn},
-#endif
-  {MODE_IMBE,         MODE_IMBE,          nullptr,         nullptr},
-  {MODE_IMBE,         MODE_IMBE_FEC,      &imbeimbefec,    nullptr},
-  {MODE_IMBE,         MODE_CODEC2_3200,   &imbepcm,        &pcmcodec23200},
-  {MODE_IMBE,         MODE_ALAW,          &imbepcm,        &pcmalaw},
-  {MODE_IMBE,         MODE_MULAW,         &imbepcm,        &pcmmulaw},
-  {MODE_IMBE,         MODE_PCM,           &imbepcm,        nullptr},
-
-#if AMBE_TYPE > 0
-  {MODE_IMBE_FEC,     MODE_DSTAR,         &imbefecpcm,     &pcmdstar},
-  {MODE_IMBE_FEC,     MODE_DMR_NXDN,      &imbefecpcm,     &pcmdmrnxdn},
-  {MODE_IMBE_FEC,     MODE_YSFDN,         &imbefecpcm,     &pcmysfdn},
-#endif
-  {MODE_IMBE_FEC,     MODE_IMBE,          &imbefecimbe,    nullptr},
-  {MODE_IMBE_FEC,     MODE_IMBE_FEC,      &imbefec,        nullptr},
-  {MODE_IMBE_FEC,     MODE_CODEC2_3200,   &imbefecpcm,     &pcmcodec23200},
-  {MODE_IMBE_FEC,     MODE_ALAW,          &imbefecpcm,     &pcmalaw},
-  {MODE_IMBE_FEC,     MODE_MULAW,         &imbefecpcm,     &pcmmulaw},
-  {MODE_IMBE_FEC,     MODE_PCM,           &imbefecpcm,     nullptr},
-
-#if AMBE_TYPE > 0
-  {MODE_CODEC2_3200,  MODE_DSTAR,         &codec23200pcm,  &pcmdstar},
-  {MODE_CODEC2_3200,  MODE_DMR_NXDN,      &codec23200pcm,  &pcmdmrnxdn},
-  {MODE_CODEC2_3200,  MODE_YSFDN,         &codec23200pcm,  &pcmysfdn},
-#endif
-  {MODE_CODEC2_3200,  MODE_IMBE,          &codec23200pcm,  &pcmimbe},
-  {MODE_CODEC2_3200,  MODE_IMBE_FEC,      &codec23200pcm,  &pcmimbefec},
-  {MODE_CODEC2_3200,  MODE_CODEC2_3200,   nullptr,         nullptr},
-  {MODE_CODEC2_3200,  MODE_ALAW,          &codec23200pcm,  &pcmalaw},
-  {MODE_CODEC2_3200,  MODE_MULAW,         &codec23200pcm,  &pcmmulaw},
-  {MODE_CODEC2_3200,  MODE_PCM,           &codec23200pcm,  nullptr},
-
-#if AMBE_TYPE > 0
-  {MODE_ALAW,         MODE_DSTAR,         &alawpcm,        &pcmdstar},
-  {MODE_ALAW,         MODE_DMR_NXDN,      &alawpcm,        &pcmdmrnxdn},
-  {MODE_ALAW,         MODE_YSFDN,         &alawpcm,        &pcmysfdn},
-#endif
-  {MODE_ALAW,         MODE_IMBE,          &alawpcm,        &pcmimbe},
-  {MODE_ALAW,         MODE_IMBE_FEC,      &alawpcm,        &pcmimbefec},
-  {MODE_ALAW,         MODE_CODEC2_3200,   &alawpcm,        &pcmcodec23200},
-  {MODE_ALAW,         MODE_MULAW,         &alawpcm,        &pcmmulaw},
-  {MODE_ALAW,         MODE_PCM,           &alawpcm,        nullptr},
-  {MODE_ALAW,         MODE_ALAW,          nullptr,         nullptr},
-
-#if AMBE_TYPE > 0
-  {MODE_MULAW,        MODE_DSTAR,         &mulawpcm,       &pcmdstar},
-  {MODE_MULAW,        MODE_DMR_NXDN,      &mulawpcm,       &pcmdmrnxdn},
-  {MODE_MULAW,        MODE_YSFDN,         &mulawpcm,       &pcmysfdn},
-#endif
-  {MODE_MULAW,        MODE_IMBE,          &mulawpcm,       &pcmimbe},
-  {MODE_MULAW,        MODE_IMBE_FEC,      &mulawpcm,       &pcmimbefec},
-  {MODE_MULAW,        MODE_CODEC2_3200,   &mulawpcm,       &pcmcodec23200},
-  {MODE_MULAW,        MODE_ALAW,          &mulawpcm,       &pcmalaw},
-  {MODE_MULAW,        MODE_PCM,           &mulawpcm,       nullptr},
-  {MODE_MULAW,        MODE_MULAW,         nullptr,         nullptr},
-
-#if AMBE_TYPE > 0
-  {MODE_PCM,          MODE_DSTAR,         &pcmdstar,       nullptr},
-  {MODE_PCM,          MODE_DMR_NXDN,      &pcmdmrnxdn,     nullptr},
-  {MODE_PCM,          MODE_YSFDN,         &pcmysfdn,       nullptr},
-#endif
-  {MODE_PCM,          MODE_IMBE,          &pcmimbe,        nullptr},
-  {MODE_PCM,          MODE_IMBE_FEC,      &pcmimbefec,     nullptr},
-  {MODE_PCM,          MODE_CODEC2_3200,   &pcmcodec23200,  nullptr},
-  {MODE_PCM,          MODE_ALAW,          &pcmalaw,        nullptr},
-  {MODE_PCM,          MODE_MULAW,         &pcmmulaw,       nullptr},
-  {MODE_PCM,          MODE_PCM,           nullptr,         nullptr}
-};
-
-const uint8_t PROCESSOR_LENGTH = sizeof(PROCESSOR_TABLE) / sizeof(PROCESSOR_TABLE[0U]);
-
 const uint8_t MMDVM_FRAME_START         = 0xE1U;
 
 const uint8_t MMDVM_GET_VERSION         = 0x00U;
@@ -156,6 +33,17 @@ const uint8_t MMDVM_SET_MODE            = 0x02U;
 const uint8_t MMDVM_ACK                 = 0x03U;
 const uint8_t MMDVM_NAK                 = 0x04U;
 const uint8_t MMDVM_DATA                = 0x05U;
+const uint8_t MMDVM_SESSION_SET_MODE    = 0x06U;
+const uint8_t MMDVM_SESSION_ACK         = 0x07U;
+const uint8_t MMDVM_SESSION_NAK         = 0x08U;
+const uint8_t MMDVM_SESSION_DATA        = 0x09U;
+const uint8_t MMDVM_DATA_BATCH          = 0x0AU;
+const uint8_t MMDVM_SESSION_CREDITS     = 0x0BU;
+const uint8_t MMDVM_SESSION_DATA_EXT    = 0x0CU;
+const uint8_t MMDVM_GET_STATS           = 0x0DU;
+const uint8_t MMDVM_GET_TRACE           = 0x0EU;
+const uint8_t MMDVM_SESSION_SET_FANOUT  = 0x0FU;
+const uint8_t MMDVM_SESSION_FANOUT_DATA = 0x10U;
 
 const uint8_t MMDVM_DEBUG               = 0xFFU;
 
@@ -176,35 +64,48 @@ HardwareSerial SerialSTLink(USART3_RX, USART3_TX);
 #define concat(a, b, c) a " (Build: " b " " c ")"
 const char HARDWARE[] = concat(VERSION, __TIME__, __DATE__);
 
-const uint8_t PROTOCOL_VERSION = 1U;
+const uint8_t PROTOCOL_VERSION = 2U;
 
 const unsigned long MAX_COMMAND_TIME_MS = 30UL;
 
+const uint16_t TRACE_REPLY_LENGTH = 300U;
+
+const uint16_t DATA_HEADER_LENGTH         = 4U;
+const uint16_t SESSION_DATA_HEADER_LENGTH = 5U;
+const uint16_t DATA_EXT_HEADER_LENGTH     = 23U;
+const uint16_t FANOUT_DATA_HEADER_LENGTH  = 6U;
+
 CSerialPort::CSerialPort() :
 m_buffer(),
-m_ptr(0U),
 m_len(0U),
+m_reply(),
+m_replyLen(0U),
 m_start(0UL),
-m_step1(nullptr),
-m_step2(nullptr)
+m_resync(false),
+m_sessions(),
+m_batches(),
+m_creditsOn(),
+m_credits(),
+m_legacy(false),
+m_hostTrace(false)
 {
 }
 
 void CSerialPort::sendACK()
 {
-  uint8_t reply[4U];
+  uint8_t* reply = beginReply();
 
   reply[0U] = MMDVM_FRAME_START;
   reply[1U] = 4U;
   reply[2U] = 0U;
   reply[3U] = MMDVM_ACK;
 
-  SerialUSB.write(reply, 4);
+  endReply(4);
 }
 
 void CSerialPort::sendNAK(uint8_t err)
 {
-  uint8_t reply[5U];
+  uint8_t* reply = beginReply();
 
   reply[0U] = MMDVM_FRAME_START;
   reply[1U] = 5U;
@@ -212,12 +113,72 @@ void CSerialPort::sendNAK(uint8_t err)
   reply[3U] = MMDVM_NAK;
   reply[4U] = err;
 
-  SerialUSB.write(reply, 5);
+  endReply(5);
+
+  stats.nak(err);
+}
+
+void CSerialPort::sendACK(uint8_t id)
+{
+  uint8_t* reply = beginReply();
+
+  reply[0U] = MMDVM_FRAME_START;
+  reply[1U] = 5U;
+  reply[2U] = 0U;
+  reply[3U] = MMDVM_SESSION_ACK;
+  reply[4U] = id;
+
+  endReply(5);
+}
+
+void CSerialPort::sendNAK(uint8_t id, uint8_t err)
+{
+  uint8_t* reply = beginReply();
+
+  reply[0U] = MMDVM_FRAME_START;
+  reply[1U] = 6U;
+  reply[2U] = 0U;
+  reply[3U] = MMDVM_SESSION_NAK;
+  reply[4U] = id;
+  reply[5U] = err;
+
+  endReply(6);
+
+  stats.nak(err);
+}
+
+void CSerialPort::sendNAK(uint8_t id, uint8_t err, const FRAME_INFO& info)
+{
+  if (isLegacy(id)) {
+    sendNAK(err);
+    return;
+  }
+
+  if (!info.m_extended) {
+    sendNAK(id, err);
+    return;
+  }
+
+  // Add the sequence number so that the host knows which frame failed
+  uint8_t* reply = beginReply();
+
+  reply[0U] = MMDVM_FRAME_START;
+  reply[1U] = 8U;
+  reply[2U] = 0U;
+  reply[3U] = MMDVM_SESSION_NAK;
+  reply[4U] = id;
+  reply[5U] = err;
+  reply[6U] = (info.m_seq >> 0) & 0xFFU;
+  reply[7U] = (info.m_seq >> 8) & 0xFFU;
+
+  endReply(8);
+
+  stats.nak(err);
 }
 
 void CSerialPort::getVersion()
 {
-  uint8_t reply[200U];
+  uint8_t* reply = beginReply();
 
   reply[0U] = MMDVM_FRAME_START;
   reply[1U] = 0U;
@@ -233,15 +194,15 @@ void CSerialPort::getVersion()
   reply[1U] = (count >> 0) & 0xFFU;
   reply[2U] = (count >> 8) & 0xFFU;
 
-  SerialUSB.write(reply, count);
+  endReply(count);
 }
 
 void CSerialPort::getCapabilities()
 {
-  uint8_t reply[10U];
+  uint8_t* reply = beginReply();
 
   reply[0U] = MMDVM_FRAME_START;
-  reply[1U] = 7U;
+  reply[1U] = 8U;
   reply[2U] = 0U;
   reply[3U] = MMDVM_RETURN_CAPABILITIES;
 
@@ -250,8 +211,139 @@ void CSerialPort::getCapabilities()
   reply[5U] = CAP_ALAW | CAP_MULAW | CAP_IMBE | CAP_CODEC2_3200;
   reply[6U] = 0x00U;
 
-  SerialUSB.write(reply, 7);
+  reply[7U] = NUM_SESSIONS;
+
+  endReply(8);
+}
+
+uint8_t CSerialPort::getStats(const uint8_t* buffer, uint16_t length)
+{
+  if (length > 1U) {
+    DEBUG1("Malformed GET_STATS command");
+    return 0x02U;
+  }
+
+  uint8_t* reply = beginReply();
+
+  reply[0U] = MMDVM_FRAME_START;
+  reply[1U] = 0U;
+  reply[2U] = 0U;
+  reply[3U] = MMDVM_GET_STATS;
+
+  uint16_t count = 4U + stats.get(reply + 4U);
+
+  reply[1U] = (count >> 0) & 0xFFU;
+  reply[2U] = (count >> 8) & 0xFFU;
+
+  endReply(count);
+
+  // Optionally start a new measurement period
+  if ((length == 1U) && ((buffer[0U] & 0x01U) == 0x01U))
+    stats.reset();
+
+  return 0x00U;
+}
+
+uint8_t CSerialPort::getTrace(uint16_t length)
+{
+  if (length != 0U) {
+    DEBUG1("Malformed GET_TRACE command");
+    return 0x02U;
+  }
+
+  // From now on the host drains the trace
+  m_hostTrace = true;
+
+  uint8_t* reply = beginReply();
+
+  reply[0U] = MMDVM_FRAME_START;
+  reply[1U] = 0U;
+  reply[2U] = 0U;
+  reply[3U] = MMDVM_GET_TRACE;
+
+  uint16_t dropped = trace.getDropped();
+  reply[4U] = (dropped >> 0) & 0xFFU;
+  reply[5U] = (dropped >> 8) & 0xFFU;
+
+  uint16_t count = 6U;
+
+  // As many complete records as will fit, the rest are left for the next request
+  while (!trace.isEmpty()) {
+    const TRACE_ENTRY& entry = trace.peek();
+
+    uint16_t textLength = ::strlen(entry.m_text);
+    if ((count + 5U + entry.m_count * 2U + textLength + 1U) > TRACE_REPLY_LENGTH)
+      break;
+
+    reply[count++] = (entry.m_time >> 0)  & 0xFFU;
+    reply[count++] = (entry.m_time >> 8)  & 0xFFU;
+    reply[count++] = (entry.m_time >> 16) & 0xFFU;
+    reply[count++] = (entry.m_time >> 24) & 0xFFU;
+
+    reply[count++] = entry.m_count;
+    for (uint8_t i = 0U; i < entry.m_count; i++) {
+      reply[count++] = (entry.m_args[i] >> 0) & 0xFFU;
+      reply[count++] = (entry.m_args[i] >> 8) & 0xFFU;
+    }
+
+    ::memcpy(reply + count, entry.m_text, textLength + 1U);
+    count += textLength + 1U;
+
+    trace.pop();
+  }
+
+  reply[1U] = (count >> 0) & 0xFFU;
+  reply[2U] = (count >> 8) & 0xFFU;
+
+  endReply(count);
+
+  return 0x00U;
+}
+
+bool CSerialPort::isIdle() const
+{
+  // Part way through receiving a command
+  if (m_len > 0U)
+    return false;
+
+  for (uint8_t i = 0U; i < NUM_SESSIONS; i++) {
+    if (m_batches[i].isActive() || m_sessions[i].hasFrames())
+      return false;
+  }
+
+  return true;
+}
+
+#if defined(DEBUGGING)
+void CSerialPort::writeTrace()
+{
+  if (m_hostTrace || trace.isEmpty())
+    return;
+
+  // One record per pass so the loop is never held up for long
+  const TRACE_ENTRY& entry = trace.peek();
+
+  switch (entry.m_count) {
+    case 0U:
+      writeDebug(entry.m_text);
+      break;
+    case 1U:
+      writeDebug(entry.m_text, entry.m_args[0U]);
+      break;
+    case 2U:
+      writeDebug(entry.m_text, entry.m_args[0U], entry.m_args[1U]);
+      break;
+    case 3U:
+      writeDebug(entry.m_text, entry.m_args[0U], entry.m_args[1U], entry.m_args[2U]);
+      break;
+    default:
+      writeDebug(entry.m_text, entry.m_args[0U], entry.m_args[1U], entry.m_args[2U], entry.m_args[3U]);
+      break;
+  }
+
+  trace.pop();
 }
+#endif
 
 void CSerialPort::start()
 {
@@ -270,49 +362,108 @@ uint8_t CSerialPort::setMode(const uint8_t* buffer, uint16_t length)
     return 0x02U;
   }
 
-  m_step1 = nullptr;
-  m_step2 = nullptr;
-
-  opmode = OPMODE::NONE;
-
   if ((buffer[0U] == MODE_PASS_THROUGH) && (buffer[1U] == MODE_PASS_THROUGH)) {
+    for (uint8_t i = 0U; i < NUM_SESSIONS; i++) {
+      m_sessions[i].close();
+      m_batches[i].reset();
+    }
+
     opmode = OPMODE::PASSTHROUGH;
-#if AMBE_TYPE == 3
-    dvsi.reset();
-#elif AMBE_TYPE == 2
-    dvsi1.reset();
-    dvsi2.reset();
-#elif AMBE_TYPE == 1
-    dvsi1.reset();
+#if AMBE_TYPE == 1 || AMBE_TYPE == 2 || AMBE_TYPE == 3
+    // The host may change the chip rates, so they are not known when passthrough ends
+    ambe.reset();
 #endif
     return 0x00U;
   }
 
-  for (uint8_t i = 0U; i < PROCESSOR_LENGTH; i++) {
-    if ((PROCESSOR_TABLE[i].m_input == buffer[0U]) && (PROCESSOR_TABLE[i].m_output == buffer[1U])) {
-      opmode  = OPMODE::TRANSCODING;
-      m_step1 = PROCESSOR_TABLE[i].m_step1;
-      m_step2 = PROCESSOR_TABLE[i].m_step2;
+  // The original protocol always addresses the first session
+  m_legacy = true;
 
-      if (m_step1 != nullptr) {
-        int8_t ret = m_step1->init(0U);
-        if (ret != 0x00U)
-          return ret;
-      }
+  return setMode(0U, buffer[0U], buffer[1U]);
+}
 
-      if (m_step2 != nullptr) {
-        int8_t ret = m_step2->init(1U);
-        if (ret != 0x00U)
-          return ret;
-      }
+uint8_t CSerialPort::setSessionMode(const uint8_t* buffer, uint16_t length)
+{
+  if (length != 3U) {
+    DEBUG1("Malformed session SET_MODE command");
+    return 0x02U;
+  }
 
-      return 0x00U;
-    }
+  if (buffer[0U] >= NUM_SESSIONS) {
+    DEBUG2("Invalid session id in SET_MODE", buffer[0U]);
+    return 0x02U;
   }
 
-  DEBUG3("Unknown SET_MODE command", buffer[0U], buffer[1U]);
+  if (buffer[0U] == 0U)
+    m_legacy = false;
+
+  // Setting both modes to passthrough closes the session
+  if ((buffer[1U] == MODE_PASS_THROUGH) && (buffer[2U] == MODE_PASS_THROUGH)) {
+    m_sessions[buffer[0U]].close();
+    m_batches[buffer[0U]].reset();
+    updateOpMode();
+    return 0x00U;
+  }
 
-  return 0x02U;
+  return setMode(buffer[0U], buffer[1U], buffer[2U]);
+}
+
+uint8_t CSerialPort::setFanout(const uint8_t* buffer, uint16_t length)
+{
+  if ((length < 3U) || (length != (3U + buffer[2U]))) {
+    DEBUG1("Malformed session SET_FANOUT command");
+    return 0x02U;
+  }
+
+  uint8_t id = buffer[0U];
+
+  if (id >= NUM_SESSIONS) {
+    DEBUG2("Invalid session id in SET_FANOUT", id);
+    return 0x02U;
+  }
+
+  if (id == 0U)
+    m_legacy = false;
+
+  if (opmode == OPMODE::PASSTHROUGH)
+    opmode = OPMODE::NONE;
+
+  m_batches[id].reset();
+  m_credits[id] = 0U;
+
+  uint8_t ret = m_sessions[id].setFanout(buffer[1U], buffer + 3U, buffer[2U]);
+
+  updateOpMode();
+
+  return ret;
+}
+
+uint8_t CSerialPort::setMode(uint8_t id, uint8_t input, uint8_t output)
+{
+  if (opmode == OPMODE::PASSTHROUGH)
+    opmode = OPMODE::NONE;
+
+  // Any batch in progress belongs to the old mode
+  m_batches[id].reset();
+
+  // Report the credits for the new mode afresh
+  m_credits[id] = 0U;
+
+  uint8_t ret = m_sessions[id].setMode(input, output);
+
+  updateOpMode();
+
+  return ret;
+}
+
+void CSerialPort::updateOpMode()
+{
+  opmode = OPMODE::NONE;
+
+  for (uint8_t i = 0U; i < NUM_SESSIONS; i++) {
+    if (m_sessions[i].isActive())
+      opmode = OPMODE::TRANSCODING;
+  }
 }
 
 uint8_t CSerialPort::sendData(const uint8_t* buffer, uint16_t length)
@@ -324,124 +475,305 @@ uint8_t CSerialPort::sendData(const uint8_t* buffer, uint16_t length)
 
 #if AMBE_TYPE > 0
     case OPMODE::PASSTHROUGH:
-      // If the RTS pin is high, then the chip does not expect any more data to be sent through
+      // Held in the driver while the RTS pin is high, rejected only once it can hold no more.
+      // Passthrough is to the first AMBE3003 chip when there are several.
 #if AMBE_TYPE == 3
-      if (!dvsi.ready()) {
-        DEBUG1("The AMBE3003 chip is not ready to receive any more data");
+      if (!dvsi[0U].write(buffer, length))
         return 0x05U;
-      } else {
-        dvsi.write(buffer, length);
-      }
 #else
-      if (!dvsi1.ready()) {
-        DEBUG1("The AMBE3000 chip is not ready to receive any more data");
+      if (!dvsi1.write(buffer, length))
         return 0x05U;
-      } else {
-        dvsi1.write(buffer, length);
-      }
 #endif
       return 0x00U;
 #endif
 
     case OPMODE::TRANSCODING:
-    default:
-      if (m_step1 != nullptr) {
-        // Start the pipeline
-        return m_step1->input(buffer, length);
-      } else {
-        // Nothing to do, just send back out
-        writeData(buffer, length);
-        return 0x00U;
+    default: {
+        FRAME_INFO info = {};
+        info.m_rx = micros();
+        return sendData(0U, buffer, length, info);
       }
   }
 }
 
-void CSerialPort::processData()
+uint8_t CSerialPort::sendSessionData(const uint8_t* buffer, uint16_t length)
 {
-  uint8_t buffer[500U];
-  int16_t length = 0;
+  if (length < 1U) {
+    DEBUG1("Malformed session DATA command");
+    return 0x02U;
+  }
+
+  if (buffer[0U] >= NUM_SESSIONS) {
+    DEBUG2("Invalid session id in DATA", buffer[0U]);
+    return 0x02U;
+  }
+
+  FRAME_INFO info = {};
+  info.m_rx = micros();
+
+  return sendData(buffer[0U], buffer + 1U, length - 1U, info);
+}
+
+uint8_t CSerialPort::sendExtendedData(const uint8_t* buffer, uint16_t length)
+{
+  if (length < 3U) {
+    DEBUG1("Malformed extended session DATA command");
+    return 0x02U;
+  }
+
+  if (buffer[0U] >= NUM_SESSIONS) {
+    DEBUG2("Invalid session id in extended DATA", buffer[0U]);
+    return 0x02U;
+  }
+
+  if (m_sessions[buffer[0U]].isFanout()) {
+    DEBUG2("Extended DATA is not supported by fan-out sessions", buffer[0U]);
+    return 0x06U;
+  }
+
+  FRAME_INFO info = {};
+  info.m_extended = true;
+  info.m_seq      = (buffer[1U] << 0) | (buffer[2U] << 8);
+  info.m_rx       = micros();
+
+  return sendData(buffer[0U], buffer + 3U, length - 3U, info);
+}
+
+uint8_t CSerialPort::sendData(uint8_t id, const uint8_t* buffer, uint16_t length, const FRAME_INFO& info)
+{
+  CSession& session = m_sessions[id];
+
+  if (!session.isActive()) {
+    DEBUG2("Received data for an inactive session", id);
+    return 0x03U;
+  }
 
+  if (m_batches[id].isActive()) {
+    DEBUG2("Received data for a session with a batch in progress", id);
+    return 0x05U;
+  }
+
+  if (session.isIdentity()) {
+    // Nothing to do, just send back out
+    stats.frameIn(id);
+    writeData(id, buffer, length, info);
+    return 0x00U;
+  }
+
+  uint8_t ret = session.input(buffer, length, info);
+  if (ret == 0x00U)
+    stats.frameIn(id);
+
+  // The host has used one of its credits
+  if ((ret == 0x00U) && (m_credits[id] > 0U))
+    m_credits[id]--;
+
+  return ret;
+}
+
+uint8_t CSerialPort::sendBatch(const uint8_t* buffer, uint16_t length)
+{
+  if (length < 1U) {
+    DEBUG1("Malformed batch DATA command");
+    return 0x02U;
+  }
+
+  uint8_t id = buffer[0U];
+
+  if (id >= NUM_SESSIONS) {
+    DEBUG2("Invalid session id in batch DATA", id);
+    return 0x02U;
+  }
+
+  if (!m_sessions[id].isActive()) {
+    DEBUG2("Received a batch for an inactive session", id);
+    return 0x03U;
+  }
+
+  if (m_sessions[id].isFanout()) {
+    DEBUG2("Batches are not supported by fan-out sessions", id);
+    return 0x06U;
+  }
+
+  // The results are matched to the frames by their order, so no other frames may still be in the session
+  if (m_sessions[id].hasFrames()) {
+    DEBUG2("Received a batch for a session with frames in flight", id);
+    return 0x05U;
+  }
+
+  uint8_t ret = m_batches[id].start(buffer + 1U, length - 1U);
+  if (ret == 0x00U)
+    stats.frameIn(id, m_batches[id].getCount());
+
+  return ret;
+}
+
+void CSerialPort::processData()
+{
   if (opmode == OPMODE::TRANSCODING) {
-    if (m_step1 != nullptr) {
-      length = m_step1->output(buffer);
-      if (length < 0) {
-        sendNAK(-length);
-        return;
+    for (uint8_t i = 0U; i < NUM_SESSIONS; i++) {
+      if (m_batches[i].isActive()) {
+        processBatch(i);
+        continue;
       }
-    }
 
-    if ((m_step2 != nullptr) && (length > 0)) {
-      m_step2->input(buffer, length);
-      length = 0U;
-    }
-
-    if (m_step2 != nullptr) {
-      length = m_step2->output(buffer);
-      if (length < 0) {
-        sendNAK(-length);
-        return;
+      if (m_sessions[i].isFanout()) {
+        uint8_t mode = MODE_PASS_THROUGH;
+        int16_t length = m_sessions[i].fanoutOutput(beginReply() + FANOUT_DATA_HEADER_LENGTH, mode);
+        if (length < 0)
+          sendNAK(i, -length);
+        else if (length > 0)
+          writeFanout(i, mode, length);
+        continue;
       }
-    }
 
-    if (length > 0)
-      writeData(buffer, length);
+      // The session writes its output straight into the reply, after room for the header
+      uint16_t space = getHeaderLength(i, m_sessions[i].hasExtended());
+
+      FRAME_INFO info;
+      int16_t length = m_sessions[i].output(beginReply() + space, info);
+      if (length < 0)
+        sendNAK(i, -length, info);
+      else if (length > 0)
+        writeData(i, space, length, info);
+    }
 #if AMBE_TYPE > 0
   } else if (opmode == OPMODE::PASSTHROUGH) {
 #if AMBE_TYPE == 3
-    length = dvsi.read(buffer);
+    uint16_t length = dvsi[0U].read(beginReply() + DATA_HEADER_LENGTH);
 #else
-    length = dvsi1.read(buffer);
+    uint16_t length = dvsi1.read(beginReply() + DATA_HEADER_LENGTH);
 #endif
-    if (length > 0)
-      writeData(buffer, length);
+    if (length > 0U)
+      writeData(length);
 #endif
   }
 }
 
-void CSerialPort::process()
+void CSerialPort::processBatch(uint8_t id)
 {
-  while (SerialUSB.available() > 0) {
-    uint8_t c = SerialUSB.read();
-
-    if (m_ptr == 0U) {
-      if (c == MMDVM_FRAME_START) {
-        // Handle the frame start correctly
-        m_buffer[0U] = c;
-        m_start = millis();
-        m_ptr   = 1U;
-        m_len   = 0U;
-      } else {
-        m_ptr   = 0U;
-        m_len   = 0U;
-      }
-    } else if (m_ptr == 1U) {
-      // Handle the frame length
-      uint8_t val = m_buffer[m_ptr] = c;
-      m_len = (val << 0) & 0x00FFU;
-      m_ptr = 2U;
-    } else if (m_ptr == 2U) {
-      // Handle the frame length
-      uint8_t val = m_buffer[m_ptr] = c;
-      m_len |= (val << 8) & 0xFF00U;
-      m_ptr  = 3U;
+  CSession& session = m_sessions[id];
+  CBatch&   batch   = m_batches[id];
+
+  // Keep the session as full as it will allow
+  uint16_t length = 0U;
+  const uint8_t* frame = batch.getInput(length);
+  if (frame != nullptr) {
+    if (session.isIdentity()) {
+      batch.input(0x00U);
+      batch.output(frame, length);
     } else {
-      // Any other bytes are added to the buffer
-      m_buffer[m_ptr] = c;
-      m_ptr++;
-
-      // The full packet has been received, process it
-      if (m_ptr == m_len) {
-        m_start = 0UL;
-        processMessage(m_buffer[3U], m_buffer + 4U, m_len - 4U);
-      }
+      uint8_t err = session.input(frame, length);
+      if (err != 0x05U)
+        batch.input(err);
+      else if (!batch.isWaiting() && batch.hasTimedOut())
+        batch.input(err);
+    }
+  }
+
+  if (batch.isWaiting()) {
+    // The session writes the frame straight into its place in the batch results
+    uint8_t* buffer = batch.getOutput();
+    int16_t len = session.output(buffer);
+    if (len != 0) {
+      batch.output(buffer, len);
+    } else if (batch.hasTimedOut()) {
+      DEBUG2("Batch frame timed out in session", id);
+
+      // A late output would otherwise be taken as that of the next frame, and every result after it would be shifted
+      session.flush();
+      batch.abandon();
     }
   }
 
+  if (batch.isComplete()) {
+    writeBatch(id);
+    batch.reset();
+  }
+}
+
+uint8_t CSerialPort::setCredits(const uint8_t* buffer, uint16_t length)
+{
+  if (length != 2U) {
+    DEBUG1("Malformed CREDITS command");
+    return 0x02U;
+  }
+
+  uint8_t id = buffer[0U];
+
+  if (id >= NUM_SESSIONS) {
+    DEBUG2("Invalid session id in CREDITS", id);
+    return 0x02U;
+  }
+
+  m_creditsOn[id] = buffer[1U] != 0x00U;
+
+  // The current credits are always returned as the reply
+  writeCredits(id);
+
+  return 0x00U;
+}
+
+uint8_t CSerialPort::getCredits(uint8_t id) const
+{
+  // A session running a batch cannot take any single frames
+  if (m_batches[id].isActive())
+    return 0U;
+
+  return m_sessions[id].space();
+}
+
+// Only an increase is reported, the host reduces its own count as it sends frames
+void CSerialPort::processCredits()
+{
+  for (uint8_t i = 0U; i < NUM_SESSIONS; i++) {
+    if (m_creditsOn[i] && (getCredits(i) > m_credits[i]))
+      writeCredits(i);
+  }
+}
+
+void CSerialPort::writeCredits(uint8_t id)
+{
+  m_credits[id] = getCredits(id);
+
+  uint8_t* reply = beginReply();
+
+  reply[0U] = MMDVM_FRAME_START;
+  reply[1U] = 6U;
+  reply[2U] = 0U;
+  reply[3U] = MMDVM_SESSION_CREDITS;
+  reply[4U] = id;
+  reply[5U] = m_credits[id];
+
+  endReply(6);
+}
+
+bool CSerialPort::isLegacy(uint8_t id) const
+{
+  return (id == 0U) && m_legacy;
+}
+
+void CSerialPort::process()
+{
+  // Read whatever has arrived in one go and handle every complete command in place
+  while (m_len < SERIAL_RX_LENGTH) {
+    int available = SerialUSB.available();
+    if (available <= 0)
+      break;
+
+    uint16_t length = SERIAL_RX_LENGTH - m_len;
+    if (uint16_t(available) < length)
+      length = available;
+
+    m_len += SerialUSB.readBytes((char*)(m_buffer + m_len), length);
+
+    parse();
+  }
+
   if (m_start > 0UL) {
     unsigned long now = millis();
     if ((now - m_start) >= MAX_COMMAND_TIME_MS) {
       DEBUG1("Command took too long to be completed");
-      m_ptr   = 0U;
       m_len   = 0U;
       m_start = 0UL;
       sendNAK(0x04U);
@@ -449,6 +781,64 @@ void CSerialPort::process()
   }
 
   processData();
+
+  processCredits();
+
+#if defined(DEBUGGING)
+  if (isIdle())
+    writeTrace();
+#endif
+
+  flushReplies();
+}
+
+void CSerialPort::parse()
+{
+  uint16_t ptr = 0U;
+
+  while (ptr < m_len) {
+    // Skip anything that is not the start of a command
+    if (m_buffer[ptr] != MMDVM_FRAME_START) {
+      ptr++;
+      continue;
+    }
+
+    if ((ptr + 3U) > m_len)
+      break;
+
+    uint16_t length = (m_buffer[ptr + 1U] << 0) | (m_buffer[ptr + 2U] << 8);
+    if ((length < 4U) || (length > SERIAL_BUFFER_LENGTH)) {
+      DEBUG2("Invalid command length received", length);
+
+      // The host hears once that its command was lost, not once for every stray start byte after it
+      if (!m_resync)
+        sendNAK(0x04U);
+
+      m_resync = true;
+      ptr++;
+      continue;
+    }
+
+    if ((ptr + length) > m_len)
+      break;
+
+    processMessage(m_buffer[ptr + 3U], m_buffer + ptr + 4U, length - 4U);
+
+    ptr += length;
+    m_start  = 0UL;
+    m_resync = false;
+  }
+
+  // Only the start of an incomplete command is kept
+  if (ptr > 0U) {
+    m_len -= ptr;
+    ::memmove(m_buffer, m_buffer + ptr, m_len);
+  }
+
+  if (m_len == 0U)
+    m_start = 0UL;
+  else if (m_start == 0UL)
+    m_start = millis();
 }
 
 void CSerialPort::processMessage(uint8_t type, const uint8_t* buffer, uint16_t length)
@@ -478,37 +868,237 @@ void CSerialPort::processMessage(uint8_t type, const uint8_t* buffer, uint16_t l
         sendNAK(err);
       break;
 
+    case MMDVM_SESSION_SET_MODE:
+      err = setSessionMode(buffer, length);
+      if (err == 0x00U)
+        sendACK(buffer[0U]);
+      else
+        sendNAK(length > 0U ? buffer[0U] : 0U, err);
+      break;
+
+    case MMDVM_SESSION_SET_FANOUT:
+      err = setFanout(buffer, length);
+      if (err == 0x00U)
+        sendACK(buffer[0U]);
+      else
+        sendNAK(length > 0U ? buffer[0U] : 0U, err);
+      break;
+
+    case MMDVM_SESSION_DATA:
+      err = sendSessionData(buffer, length);
+      if (err != 0x00U)
+        sendNAK(length > 0U ? buffer[0U] : 0U, err);
+      break;
+
+    case MMDVM_SESSION_DATA_EXT:
+      err = sendExtendedData(buffer, length);
+      if (err != 0x00U) {
+        FRAME_INFO info = {};
+        info.m_extended = length >= 3U;
+        info.m_seq      = length >= 3U ? ((buffer[1U] << 0) | (buffer[2U] << 8)) : 0U;
+        sendNAK(length > 0U ? buffer[0U] : 0U, err, info);
+      }
+      break;
+
+    case MMDVM_DATA_BATCH:
+      err = sendBatch(buffer, length);
+      if (err != 0x00U)
+        sendNAK(length > 0U ? buffer[0U] : 0U, err);
+      break;
+
+    case MMDVM_SESSION_CREDITS:
+      err = setCredits(buffer, length);
+      if (err != 0x00U)
+        sendNAK(length > 0U ? buffer[0U] : 0U, err);
+      break;
+
+    case MMDVM_GET_TRACE:
+      err = getTrace(length);
+      if (err != 0x00U)
+        sendNAK(err);
+      break;
+
+    case MMDVM_GET_STATS:
+      err = getStats(buffer, length);
+      if (err != 0x00U)
+        sendNAK(err);
+      break;
+
     default:
       // Handle this, send a NAK back
       DEBUG2("Invalid command received", type);
       sendNAK(0x00U);
       break;
   }
-
-  m_ptr = 0U;
-  m_len = 0U;
 }
 
 void CSerialPort::writeData(const uint8_t* data, uint16_t length)
+{
+  uint8_t* reply = beginReply();
+
+  ::memcpy(reply + DATA_HEADER_LENGTH, data, length);
+
+  writeData(length);
+}
+
+void CSerialPort::writeData(uint16_t length)
 {
   if (opmode == OPMODE::NONE)
     return;
 
-  uint8_t reply[500U];
+  uint8_t* reply = beginReply();
+
+  uint16_t count = DATA_HEADER_LENGTH + length;
 
   reply[0U] = MMDVM_FRAME_START;
-  reply[1U] = 0U;
-  reply[2U] = 0U;
+  reply[1U] = (count >> 0) & 0xFFU;
+  reply[2U] = (count >> 8) & 0xFFU;
   reply[3U] = MMDVM_DATA;
 
-  uint16_t count = 4U;
-  for (uint16_t i = 0U; i < length; i++, count++)
-    reply[count] = data[i];
+  endReply(count);
+}
+
+void CSerialPort::writeData(uint8_t id, const uint8_t* data, uint16_t length, const FRAME_INFO& info)
+{
+  uint8_t* reply = beginReply();
+
+  ::memcpy(reply + DATA_EXT_HEADER_LENGTH, data, length);
+
+  writeData(id, DATA_EXT_HEADER_LENGTH, length, info);
+}
+
+uint16_t CSerialPort::getHeaderLength(uint8_t id, bool extended) const
+{
+  if (isLegacy(id))
+    return DATA_HEADER_LENGTH;
+  else if (extended)
+    return DATA_EXT_HEADER_LENGTH;
+  else
+    return SESSION_DATA_HEADER_LENGTH;
+}
+
+void CSerialPort::writeData(uint8_t id, uint16_t space, uint16_t length, const FRAME_INFO& info)
+{
+  stats.frameOut(id);
+
+  uint8_t* reply = beginReply();
+
+  uint16_t header = getHeaderLength(id, info.m_extended);
+
+  // Plain and extended frames in flight together may leave too little room for the header
+  if (header > space) {
+    ::memmove(reply + header, reply + space, length);
+    space = header;
+  }
+
+  // The header goes immediately in front of the payload
+  uint16_t offset = space - header;
+  reply += offset;
+
+  uint16_t count = header + length;
+
+  reply[0U] = MMDVM_FRAME_START;
+  reply[1U] = (count >> 0) & 0xFFU;
+  reply[2U] = (count >> 8) & 0xFFU;
+
+  if (isLegacy(id)) {
+    reply[3U] = MMDVM_DATA;
+  } else if (info.m_extended) {
+    reply[3U] = MMDVM_SESSION_DATA_EXT;
+    reply[4U] = id;
+    reply[5U] = (info.m_seq >> 0) & 0xFFU;
+    reply[6U] = (info.m_seq >> 8) & 0xFFU;
+
+    // The transmit timestamp is when the reply is queued for the host
+    uint32_t tx = micros();
+
+    uint32_t timestamps[4U] = {info.m_rx, info.m_ambeWrite, info.m_ambeRead, tx};
+    for (uint8_t i = 0U; i < 4U; i++) {
+      reply[7U + i * 4U + 0U] = (timestamps[i] >> 0)  & 0xFFU;
+      reply[7U + i * 4U + 1U] = (timestamps[i] >> 8)  & 0xFFU;
+      reply[7U + i * 4U + 2U] = (timestamps[i] >> 16) & 0xFFU;
+      reply[7U + i * 4U + 3U] = (timestamps[i] >> 24) & 0xFFU;
+    }
+  } else {
+    reply[3U] = MMDVM_SESSION_DATA;
+    reply[4U] = id;
+  }
 
+  endReply(count, offset);
+}
+
+void CSerialPort::writeFanout(uint8_t id, uint8_t mode, uint16_t length)
+{
+  stats.frameOut(id);
+
+  uint8_t* reply = beginReply();
+
+  uint16_t count = FANOUT_DATA_HEADER_LENGTH + length;
+
+  reply[0U] = MMDVM_FRAME_START;
   reply[1U] = (count >> 0) & 0xFFU;
   reply[2U] = (count >> 8) & 0xFFU;
+  reply[3U] = MMDVM_SESSION_FANOUT_DATA;
+  reply[4U] = id;
+  reply[5U] = mode;
+
+  endReply(count);
+}
+
+void CSerialPort::writeBatch(uint8_t id)
+{
+  uint16_t length = 0U;
+  const uint8_t* results = m_batches[id].getResults(length);
+
+  uint16_t outLength = m_batches[id].getOutputLength();
+
+  uint8_t* reply = beginReply();
+
+  uint16_t count = 8U + length;
+
+  reply[0U] = MMDVM_FRAME_START;
+  reply[1U] = (count >> 0) & 0xFFU;
+  reply[2U] = (count >> 8) & 0xFFU;
+  reply[3U] = MMDVM_DATA_BATCH;
+  reply[4U] = id;
+  reply[5U] = m_batches[id].getCount();
+  reply[6U] = (outLength >> 0) & 0xFFU;
+  reply[7U] = (outLength >> 8) & 0xFFU;
+
+  ::memcpy(reply + 8U, results, length);
+
+  endReply(count);
+
+  stats.frameOut(id, m_batches[id].getCount());
+}
+
+// There is always room for the largest reply after those already queued
+uint8_t* CSerialPort::beginReply()
+{
+  return m_reply + m_replyLen;
+}
+
+void CSerialPort::endReply(uint16_t length, uint16_t offset)
+{
+  if (offset > 0U)
+    ::memmove(m_reply + m_replyLen, m_reply + m_replyLen + offset, length);
+
+  m_replyLen += length;
+
+  // The rest go at the end of the loop pass
+  if (m_replyLen >= SERIAL_TX_LENGTH)
+    flushReplies();
+}
+
+// All of the queued replies go to the host as one transfer
+void CSerialPort::flushReplies()
+{
+  if (m_replyLen == 0U)
+    return;
+
+  SerialUSB.write(m_reply, m_replyLen);
 
-  SerialUSB.write(reply, count);
+  m_replyLen = 0U;
 }
 
 #if defined(DEBUGGING)
@@ -517,7 +1107,7 @@ void CSerialPort::writeDebug(const char* text)
 #if defined(HAS_STLINK)
   SerialSTLink.printf("Debug: \"%s\"\r\n", text);
 #else
-  uint8_t reply[300U];
+  uint8_t* reply = beginReply();
 
   reply[0U] = MMDVM_FRAME_START;
   reply[1U] = 0U;
@@ -531,7 +1121,7 @@ void CSerialPort::writeDebug(const char* text)
   reply[1U] = (count >> 0) & 0xFFU;
   reply[2U] = (count >> 8) & 0xFFU;
 
-  SerialUSB.write(reply, count);
+  endReply(count);
 #endif
 }
 
@@ -540,7 +1130,7 @@ void CSerialPort::writeDebug(const char* text, int16_t n1)
 #if defined(HAS_STLINK)
   SerialSTLink.printf("Debug: \"%s\" %u\r\n", text, n1);
 #else
-  uint8_t reply[300U];
+  uint8_t* reply = beginReply();
 
   reply[0U] = MMDVM_FRAME_START;
   reply[1U] = 0U;
@@ -557,7 +1147,7 @@ void CSerialPort::writeDebug(const char* text, int16_t n1)
   reply[1U] = (count >> 0) & 0xFFU;
   reply[2U] = (count >> 8) & 0xFFU;
 
-  SerialUSB.write(reply, count);
+  endReply(count);
 #endif
 }
 
@@ -566,7 +1156,7 @@ void CSerialPort::writeDebug(const char* text, int16_t n1, int16_t n2)
 #if defined(HAS_STLINK)
   SerialSTLink.printf("Debug: \"%s\" %u %u\r\n", text, n1, n2);
 #else
-  uint8_t reply[300U];
+  uint8_t* reply = beginReply();
 
   reply[0U] = MMDVM_FRAME_START;
   reply[1U] = 0U;
@@ -586,7 +1176,7 @@ void CSerialPort::writeDebug(const char* text, int16_t n1, int16_t n2)
   reply[1U] = (count >> 0) & 0xFFU;
   reply[2U] = (count >> 8) & 0xFFU;
 
-  SerialUSB.write(reply, count);
+  endReply(count);
 #endif
 }
 
@@ -595,7 +1185,7 @@ void CSerialPort::writeDebug(const char* text, int16_t n1, int16_t n2, int16_t n
 #if defined(HAS_STLINK)
   SerialSTLink.printf("Debug: \"%s\" %u %u %u\r\n", text, n1, n2, n3);
 #else
-  uint8_t reply[300U];
+  uint8_t* reply = beginReply();
 
   reply[0U] = MMDVM_FRAME_START;
   reply[1U] = 0U;
@@ -618,7 +1208,7 @@ void CSerialPort::writeDebug(const char* text, int16_t n1, int16_t n2, int16_t n
   reply[1U] = (count >> 0) & 0xFFU;
   reply[2U] = (count >> 8) & 0xFFU;
 
-  SerialUSB.write(reply, count);
+  endReply(count);
 #endif
 }
 
@@ -627,7 +1217,7 @@ void CSerialPort::writeDebug(const char* text, int16_t n1, int16_t n2, int16_t n
 #if defined(HAS_STLINK)
   SerialSTLink.printf("Debug: \"%s\" %u %u %u %u\r\n", text, n1, n2, n3, n4);
 #else
-  uint8_t reply[300U];
+  uint8_t* reply = beginReply();
 
   reply[0U] = MMDVM_FRAME_START;
   reply[1U] = 0U;
@@ -653,7 +1243,7 @@ void CSerialPort::writeDebug(const char* text, int16_t n1, int16_t n2, int16_t n
   reply[1U] = (count >> 0) & 0xFFU;
   reply[2U] = (count >> 8) & 0xFFU;
 
-  SerialUSB.write(reply, count);
+  endReply(count);
 #endif
 }
 
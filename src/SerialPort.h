@@ -21,12 +21,22 @@
 
 #include "Config.h"
 #include "Globals.h"
-#include "Processor.h"
+#include "Session.h"
+#include "Batch.h"
 
 #if !defined(SERIAL_SPEED)
 #define SERIAL_SPEED 460800
 #endif
 
+// Large enough for a full batch of PCM frames
+const uint16_t SERIAL_BUFFER_LENGTH = 10U + MAX_BATCH_FRAMES * MAX_BATCH_FRAME_LENGTH;
+
+// Room for a partly received command as well as the next one
+const uint16_t SERIAL_RX_LENGTH = 2U * SERIAL_BUFFER_LENGTH;
+
+// The largest reply, a full batch of PCM frames each with an error code
+const uint16_t SERIAL_TX_LENGTH = 8U + MAX_BATCH_FRAMES * (MAX_BATCH_FRAME_LENGTH + 1U);
+
 class CSerialPort {
 public:
   CSerialPort();
@@ -50,24 +60,61 @@ public:
 #endif
 
 private:
-  uint8_t       m_buffer[512U];
-  uint16_t      m_ptr;
+  uint8_t       m_buffer[SERIAL_RX_LENGTH];
   uint16_t      m_len;
+  uint8_t       m_reply[2U * SERIAL_TX_LENGTH];
+  uint16_t      m_replyLen;
   unsigned long m_start;
+  bool          m_resync;
 
-  IProcessor* m_step1;
-  IProcessor* m_step2;
+  CSession      m_sessions[NUM_SESSIONS];
+  CBatch        m_batches[NUM_SESSIONS];
+  bool          m_creditsOn[NUM_SESSIONS];
+  uint8_t       m_credits[NUM_SESSIONS];
+  bool          m_legacy;
+  bool          m_hostTrace;
 
   void    sendACK();
+  void    sendACK(uint8_t id);
   void    sendNAK(uint8_t err);
+  void    sendNAK(uint8_t id, uint8_t err);
+  void    sendNAK(uint8_t id, uint8_t err, const FRAME_INFO& info);
   void    getVersion();
   void    getCapabilities();
+  uint8_t getStats(const uint8_t* data, uint16_t length);
+  uint8_t getTrace(uint16_t length);
+  bool    isIdle() const;
   uint8_t setMode(const uint8_t* data, uint16_t length);
+  uint8_t setSessionMode(const uint8_t* data, uint16_t length);
+  uint8_t setMode(uint8_t id, uint8_t input, uint8_t output);
+  uint8_t setFanout(const uint8_t* data, uint16_t length);
+  void    updateOpMode();
   uint8_t sendData(const uint8_t* data, uint16_t length);
+  uint8_t sendSessionData(const uint8_t* data, uint16_t length);
+  uint8_t sendExtendedData(const uint8_t* data, uint16_t length);
+  uint8_t sendData(uint8_t id, const uint8_t* data, uint16_t length, const FRAME_INFO& info);
+  uint8_t sendBatch(const uint8_t* data, uint16_t length);
+  void    writeData(uint16_t length);
+  void    writeData(uint8_t id, const uint8_t* data, uint16_t length, const FRAME_INFO& info);
+  void    writeData(uint8_t id, uint16_t space, uint16_t length, const FRAME_INFO& info);
+  uint16_t getHeaderLength(uint8_t id, bool extended) const;
+  uint8_t* beginReply();
+  void    endReply(uint16_t length, uint16_t offset = 0U);
+  void    flushReplies();
+  bool    isLegacy(uint8_t id) const;
+  void    parse();
   void    processMessage(uint8_t type, const uint8_t* data, uint16_t length);
   void    processData();
+  void    processBatch(uint8_t id);
+  void    writeBatch(uint8_t id);
+  void    writeFanout(uint8_t id, uint8_t mode, uint16_t length);
+  uint8_t setCredits(const uint8_t* data, uint16_t length);
+  uint8_t getCredits(uint8_t id) const;
+  void    processCredits();
+  void    writeCredits(uint8_t id);
 
 #if defined(DEBUGGING)
+  void     writeTrace();
   uint16_t convert(int16_t num, uint8_t* buffer);
   void     reverse(uint8_t* buffer, uint16_t length) const;
 #endif
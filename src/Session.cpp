@@ -0,0 +1,711 @@
+/*
+ *   Copyright (C) 2026 by Jonathan Naylor G4KLX
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "Session.h"
+
+#include "ModeDefines.h"
+#include "Globals.h"
+#include "Silence.h"
+#include "Debug.h"
+
+#if AMBE_TYPE == 3
+const uint8_t AMBE_CHANNELS = AMBE3003_POOL_CHANNELS;
+#elif AMBE_TYPE == 2
+const uint8_t AMBE_CHANNELS = 2U;
+#elif AMBE_TYPE == 1
+const uint8_t AMBE_CHANNELS = 1U;
+#else
+const uint8_t AMBE_CHANNELS = 0U;
+#endif
+
+// The DVSI vocoder channels currently owned by a session, one bit per channel
+static uint16_t channelsInUse = 0x0000U;
+
+static void releaseChannel(int8_t n)
+{
+  if (n < 0)
+    return;
+
+  channelsInUse &= ~(1U << n);
+  stats.channelReleased(n);
+}
+
+template <class S, class F>
+decltype(auto) CSession::dispatch(S& session, PROCESSOR type, F f)
+{
+  switch (type) {
+    case PROCESSOR::DSTAR_FEC:       return f(session.m_dstarfec);
+    case PROCESSOR::DMR_NXDN_FEC:    return f(session.m_dmrnxdnfec);
+    case PROCESSOR::YSFDN_FEC:       return f(session.m_ysfdnfec);
+    case PROCESSOR::IMBE_FEC:        return f(session.m_imbefec);
+#if AMBE_TYPE > 0
+    case PROCESSOR::DSTAR_PCM:       return f(session.m_dstarpcm);
+    case PROCESSOR::DMR_NXDN_PCM:    return f(session.m_dmrnxdnpcm);
+    case PROCESSOR::YSFDN_PCM:       return f(session.m_ysfdnpcm);
+#endif
+    case PROCESSOR::IMBE_PCM:        return f(session.m_imbepcm);
+    case PROCESSOR::IMBE_FEC_PCM:    return f(session.m_imbefecpcm);
+    case PROCESSOR::CODEC2_3200_PCM: return f(session.m_codec23200pcm);
+    case PROCESSOR::ALAW_PCM:        return f(session.m_alawpcm);
+    case PROCESSOR::MULAW_PCM:       return f(session.m_mulawpcm);
+#if AMBE_TYPE > 0
+    case PROCESSOR::PCM_DSTAR:       return f(session.m_pcmdstar);
+    case PROCESSOR::PCM_DMR_NXDN:    return f(session.m_pcmdmrnxdn);
+    case PROCESSOR::PCM_YSFDN:       return f(session.m_pcmysfdn);
+#endif
+    case PROCESSOR::PCM_IMBE:        return f(session.m_pcmimbe);
+    case PROCESSOR::PCM_IMBE_FEC:    return f(session.m_pcmimbefec);
+    case PROCESSOR::PCM_CODEC2_3200: return f(session.m_pcmcodec23200);
+    case PROCESSOR::PCM_ALAW:        return f(session.m_pcmalaw);
+    case PROCESSOR::PCM_MULAW:       return f(session.m_pcmmulaw);
+    case PROCESSOR::YSFDN_DMR_NXDN:  return f(session.m_ysfdndmrnxdn);
+    case PROCESSOR::DMR_NXDN_YSFDN:  return f(session.m_dmrnxdnysfdn);
+    case PROCESSOR::IMBE_IMBE_FEC:   return f(session.m_imbeimbefec);
+    case PROCESSOR::IMBE_FEC_IMBE:   return f(session.m_imbefecimbe);
+#if defined(MODEL_TRANSCODING)
+    case PROCESSOR::IMBE_CODEC2_3200: return f(session.m_imbecodec23200);
+    case PROCESSOR::CODEC2_3200_IMBE: return f(session.m_codec23200imbe);
+#endif
+    default:                         return decltype(f(session.m_dstarfec))();
+  }
+}
+
+CSession::CSession() :
+m_active(false),
+m_stages(0U),
+m_step(),
+m_channel(),
+m_ambe(),
+m_inStage(),
+m_input(MODE_PASS_THROUGH),
+m_output(MODE_PASS_THROUGH),
+m_silence(false),
+m_silenceCount(0U),
+m_info(),
+m_infoHead(0U),
+m_infoCount(0U),
+m_outputs(0U),
+m_outputMode(),
+m_branch(),
+m_branchChannel(),
+m_nextBranch(0U),
+m_branchPending(0U),
+m_pcm(),
+m_dstarfec(),
+m_dmrnxdnfec(),
+m_ysfdnfec(),
+m_imbefec(),
+#if AMBE_TYPE > 0
+m_ysfdnpcm(),
+m_dstarpcm(),
+m_dmrnxdnpcm(),
+#endif
+m_imbepcm(),
+m_imbefecpcm(),
+m_codec23200pcm(),
+#if AMBE_TYPE > 0
+m_pcmysfdn(),
+m_pcmdstar(),
+m_pcmdmrnxdn(),
+#endif
+m_pcmimbe(),
+m_pcmimbefec(),
+m_pcmcodec23200(),
+m_ysfdndmrnxdn(),
+m_dmrnxdnysfdn(),
+m_imbeimbefec(),
+m_imbefecimbe(),
+#if defined(MODEL_TRANSCODING)
+m_imbecodec23200(),
+m_codec23200imbe(),
+#endif
+m_alawpcm(),
+m_pcmalaw(),
+m_mulawpcm(),
+m_pcmmulaw()
+{
+  for (uint8_t i = 0U; i < MAX_STAGES; i++)
+    m_channel[i] = -1;
+
+  for (uint8_t i = 0U; i < MAX_FANOUT_OUTPUTS; i++)
+    m_branchChannel[i] = -1;
+}
+
+uint8_t CSession::setMode(uint8_t input, uint8_t output)
+{
+  close();
+
+  const ROUTE* route = findRoute(input, output);
+  if (route == nullptr) {
+    DEBUG3("Unknown SET_MODE command", input, output);
+    return 0x02U;
+  }
+
+  uint8_t ret = initRoute(*route);
+  if (ret != 0x00U) {
+    close();
+    return ret;
+  }
+
+#if defined(SILENCE_FAST_PATH)
+  // Only worth doing when there is a vocoder to skip
+  bool vocoder = false;
+  for (uint8_t i = 0U; i < m_stages; i++)
+    vocoder = vocoder || usesVocoder(m_step[i]);
+
+  m_input   = input;
+  m_output  = output;
+  m_silence = vocoder && CSilence::hasSilence(input) && CSilence::hasSilence(output);
+#endif
+
+  m_active = true;
+
+  return 0x00U;
+}
+
+uint8_t CSession::setFanout(uint8_t input, const uint8_t* outputs, uint8_t count)
+{
+  close();
+
+  if ((count == 0U) || (count > MAX_FANOUT_OUTPUTS)) {
+    DEBUG2("Invalid number of fan-out outputs", count);
+    return 0x02U;
+  }
+
+  const ROUTE* decode = findRoute(input, MODE_PCM);
+  if (decode == nullptr) {
+    DEBUG2("Unknown fan-out input mode", input);
+    return 0x02U;
+  }
+
+  // Check the whole request before taking any AMBE channels
+  const ROUTE* encode[MAX_FANOUT_OUTPUTS];
+  for (uint8_t i = 0U; i < count; i++) {
+    for (uint8_t j = 0U; j < i; j++) {
+      if (outputs[j] == outputs[i]) {
+        DEBUG2("Repeated fan-out output mode", outputs[i]);
+        return 0x02U;
+      }
+    }
+
+    encode[i] = findRoute(MODE_PCM, outputs[i]);
+    if (encode[i] == nullptr) {
+      DEBUG2("Unknown fan-out output mode", outputs[i]);
+      return 0x02U;
+    }
+  }
+
+  uint8_t ret = initRoute(*decode);
+  if (ret != 0x00U) {
+    close();
+    return ret;
+  }
+
+  for (uint8_t i = 0U; i < count; i++) {
+    // A PCM output has no processor, the decoded frames are queued as they are
+    PROCESSOR type = (encode[i]->m_stages > 0U) ? encode[i]->m_stage[0U] : PROCESSOR::NONE;
+
+    m_branch[i]     = type;
+    m_outputMode[i] = outputs[i];
+
+    ret = initStep(type, m_branchChannel[i]);
+    if (ret != 0x00U) {
+      close();
+      return ret;
+    }
+  }
+
+  m_outputs = count;
+  m_active  = true;
+
+  return 0x00U;
+}
+
+void CSession::close()
+{
+  for (uint8_t i = 0U; i < MAX_STAGES; i++) {
+    releaseStep(m_step[i]);
+    releaseChannel(m_channel[i]);
+
+    m_step[i]    = PROCESSOR::NONE;
+    m_channel[i] = -1;
+    m_ambe[i]    = false;
+    m_inStage[i] = 0U;
+  }
+
+  for (uint8_t i = 0U; i < MAX_FANOUT_OUTPUTS; i++) {
+    releaseStep(m_branch[i]);
+    releaseChannel(m_branchChannel[i]);
+
+    m_branch[i]        = PROCESSOR::NONE;
+    m_branchChannel[i] = -1;
+  }
+
+  m_outputs       = 0U;
+  m_nextBranch    = 0U;
+  m_branchPending = 0U;
+  m_pcm.reset();
+
+  m_active = false;
+  m_stages = 0U;
+
+  m_silence      = false;
+  m_silenceCount = 0U;
+
+  m_infoHead  = 0U;
+  m_infoCount = 0U;
+}
+
+void CSession::flush()
+{
+  for (uint8_t i = 0U; i < m_stages; i++) {
+    stepFlush(m_step[i]);
+    m_inStage[i] = 0U;
+  }
+
+  for (uint8_t i = 0U; i < m_outputs; i++)
+    stepFlush(m_branch[i]);
+
+  m_nextBranch    = 0U;
+  m_branchPending = 0U;
+  m_pcm.reset();
+
+  m_silenceCount = 0U;
+
+  m_infoHead  = 0U;
+  m_infoCount = 0U;
+}
+
+bool CSession::isActive() const
+{
+  return m_active;
+}
+
+bool CSession::isIdentity() const
+{
+  return m_active && (m_stages == 0U) && (m_outputs == 0U);
+}
+
+bool CSession::isFanout() const
+{
+  return m_active && (m_outputs > 0U);
+}
+
+bool CSession::hasFrames() const
+{
+  return (m_infoCount > 0U) || (m_branchPending > 0U);
+}
+
+bool CSession::hasExtended() const
+{
+  for (uint8_t i = 0U; i < m_infoCount; i++) {
+    if (m_info[(m_infoHead + i) % FRAME_INFO_DEPTH].m_extended)
+      return true;
+  }
+
+  return false;
+}
+
+uint8_t CSession::space() const
+{
+  if (!m_active)
+    return 0U;
+
+  // PCM fanned straight out to the outputs
+  if ((m_stages == 0U) && (m_outputs > 0U))
+    return branchSpace();
+
+  // Every frame in flight, silent ones included, holds an entry until it is output
+  uint8_t space = FRAME_INFO_DEPTH - m_infoCount;
+
+  // Identity sessions send the frame straight back out
+  uint8_t stage = (m_stages == 0U) ? FRAME_QUEUE_DEPTH : stepSpace(m_step[0U]);
+
+  return (stage < space) ? stage : space;
+}
+
+uint8_t CSession::input(const uint8_t* buffer, uint16_t length)
+{
+  FRAME_INFO info = {};
+
+  return input(buffer, length, info);
+}
+
+uint8_t CSession::input(const uint8_t* buffer, uint16_t length, const FRAME_INFO& info)
+{
+  if (!m_active) {
+    DEBUG1("Received data for an inactive session");
+    return 0x03U;
+  }
+
+  if ((m_stages == 0U) && (m_outputs > 0U))
+    return branchInput(buffer, length);
+
+  if (m_infoCount >= FRAME_INFO_DEPTH) {
+    DEBUG1("Too many frames in flight in the session");
+    return 0x05U;
+  }
+
+  FRAME_INFO& entry = m_info[(m_infoHead + m_infoCount) % FRAME_INFO_DEPTH];
+
+  // Silence bypasses the pipeline, but only while no other frames are in it so that they stay in order
+  if (m_silence && (m_infoCount == m_silenceCount) && CSilence::isSilence(m_input, buffer, length)) {
+    entry = info;
+    entry.m_ambeWrite = 0UL;
+    entry.m_ambeRead  = 0UL;
+    m_infoCount++;
+    m_silenceCount++;
+
+    return 0x00U;
+  }
+
+  // Start the pipeline
+  uint8_t ret = stepInput(m_step[0U], buffer, length);
+  if (ret != 0x00U)
+    return ret;
+
+  entry = info;
+  entry.m_ambeWrite = m_ambe[0U] ? micros() : 0UL;
+  entry.m_ambeRead  = 0UL;
+  m_infoCount++;
+  m_inStage[0U]++;
+
+  return 0x00U;
+}
+
+int16_t CSession::output(uint8_t* buffer)
+{
+  FRAME_INFO info;
+
+  return output(buffer, info);
+}
+
+int16_t CSession::output(uint8_t* buffer, FRAME_INFO& info)
+{
+  // The silent frames are the oldest ones
+  if (m_silenceCount > 0U) {
+    info = removeInfo(0U);
+    m_silenceCount--;
+
+    return CSilence::getSilence(m_output, buffer);
+  }
+
+  const uint8_t* frame = buffer;
+
+  int16_t length = peekOutput(buffer, frame, info);
+  if (length <= 0)
+    return length;
+
+  // This is the one copy of the frame, from where the last stage holds it into the reply
+  if (frame != buffer)
+    ::memcpy(buffer, frame, length);
+
+  stepDiscard(m_step[m_stages - 1U]);
+
+  return length;
+}
+
+int16_t CSession::peekOutput(uint8_t* scratch, const uint8_t*& frame, FRAME_INFO& info)
+{
+  if (!m_active || (m_stages == 0U))
+    return 0;
+
+  // Move frames along the pipeline, a frame can pass through every stage that has room for it
+  for (uint8_t n = 0U; n < (m_stages - 1U); n++) {
+    int16_t length = transfer(n, scratch, info);
+    if (length < 0)
+      return length;
+  }
+
+  uint8_t last = m_stages - 1U;
+
+  int16_t length = stepPeek(m_step[last], scratch, frame);
+  if (length == 0)
+    return 0;
+
+  info = removeInfo(0U);
+  if (m_inStage[last] > 0U)
+    m_inStage[last]--;
+
+  if ((length > 0) && m_ambe[last])
+    info.m_ambeRead = micros();
+
+  return length;
+}
+
+int16_t CSession::transfer(uint8_t n, uint8_t* scratch, FRAME_INFO& info)
+{
+  // Leave the frame in this stage until the next one has room for it
+  if (stepSpace(m_step[n + 1U]) == 0U)
+    return 0;
+
+  // The next stage reads the frame where this stage holds it
+  const uint8_t* frame = scratch;
+  int16_t length = stepPeek(m_step[n], scratch, frame);
+  if (length == 0)
+    return 0;
+
+  // Frames move along the pipeline in order, so the oldest one in this stage follows all of those in the later stages
+  uint8_t offset = 0U;
+  for (uint8_t i = n + 1U; i < m_stages; i++)
+    offset += m_inStage[i];
+
+  if (m_inStage[n] > 0U)
+    m_inStage[n]--;
+
+  if (length < 0) {
+    info = removeInfo(offset);
+    return length;
+  }
+
+  FRAME_INFO& entry = m_info[(m_infoHead + offset) % FRAME_INFO_DEPTH];
+  if (m_ambe[n])
+    entry.m_ambeRead = micros();
+
+  uint8_t ret = stepInput(m_step[n + 1U], frame, length);
+  stepDiscard(m_step[n]);
+
+  if (ret != 0x00U) {
+    info = removeInfo(offset);
+    return -int16_t(ret);
+  }
+
+  // With several AMBE stages the timestamps span the whole DVSI round trip
+  if (m_ambe[n + 1U]) {
+    bool earlier = false;
+    for (uint8_t i = 0U; i <= n; i++)
+      earlier = earlier || m_ambe[i];
+
+    if (!earlier)
+      entry.m_ambeWrite = micros();
+    entry.m_ambeRead = 0UL;
+  }
+
+  m_inStage[n + 1U]++;
+
+  return length;
+}
+
+uint8_t CSession::stepSpace(PROCESSOR type) const
+{
+  return dispatch(*this, type, [](const auto& step) { return step.space(); });
+}
+
+uint8_t CSession::stepInput(PROCESSOR type, const uint8_t* buffer, uint16_t length)
+{
+  uint32_t start = CStats::cycles();
+
+  uint8_t ret = dispatch(*this, type, [=](auto& step) { return step.input(buffer, length); });
+
+  stats.stage(STAGE::PROCESSOR_INPUT, start);
+
+  return ret;
+}
+
+int16_t CSession::stepOutput(PROCESSOR type, uint8_t* buffer)
+{
+  uint32_t start = CStats::cycles();
+
+  int16_t length = dispatch(*this, type, [=](auto& step) { return step.output(buffer); });
+
+  // Only count the calls that did some work, not the polling
+  if (length != 0)
+    stats.stage(STAGE::PROCESSOR_OUTPUT, start);
+
+  return length;
+}
+
+int16_t CSession::stepPeek(PROCESSOR type, uint8_t* scratch, const uint8_t*& frame)
+{
+  uint32_t start = CStats::cycles();
+
+  int16_t length = dispatch(*this, type, [&](auto& step) { return step.peek(scratch, frame); });
+
+  if (length != 0)
+    stats.stage(STAGE::PROCESSOR_OUTPUT, start);
+
+  return length;
+}
+
+void CSession::stepDiscard(PROCESSOR type)
+{
+  dispatch(*this, type, [](auto& step) { step.discard(); });
+}
+
+void CSession::stepFlush(PROCESSOR type)
+{
+  dispatch(*this, type, [](auto& step) { step.flush(); });
+}
+
+int16_t CSession::fanoutOutput(uint8_t* buffer, uint8_t& mode)
+{
+  if (!isFanout())
+    return 0;
+
+  // A decoded frame only moves on once every output can take it
+  if ((m_stages > 0U) && (branchSpace() > 0U)) {
+    FRAME_INFO info;
+    const uint8_t* frame = buffer;
+
+    // The outputs are encoded from the decoded frame where the last stage holds it
+    int16_t length = peekOutput(buffer, frame, info);
+    if (length < 0)
+      return length;
+
+    if (length > 0) {
+      uint8_t ret = branchInput(frame, length);
+      stepDiscard(m_step[m_stages - 1U]);
+
+      if (ret != 0x00U)
+        return -int16_t(ret);
+    }
+  }
+
+  // Take the outputs in turn so that none of them is starved
+  for (uint8_t n = 0U; n < m_outputs; n++) {
+    uint8_t i = (m_nextBranch + n) % m_outputs;
+
+    int16_t length = 0;
+    if (m_branch[i] != PROCESSOR::NONE)
+      length = stepOutput(m_branch[i], buffer);
+    else
+      length = m_pcm.pop(buffer);
+
+    if (length != 0) {
+      if (m_branchPending > 0U)
+        m_branchPending--;
+
+      mode         = m_outputMode[i];
+      m_nextBranch = (i + 1U) % m_outputs;
+
+      return length;
+    }
+  }
+
+  return 0;
+}
+
+uint8_t CSession::branchSpace() const
+{
+  uint8_t space = FRAME_QUEUE_DEPTH;
+
+  for (uint8_t i = 0U; i < m_outputs; i++) {
+    uint8_t n = (m_branch[i] != PROCESSOR::NONE) ? stepSpace(m_branch[i]) : m_pcm.space();
+    if (n < space)
+      space = n;
+  }
+
+  return space;
+}
+
+uint8_t CSession::branchInput(const uint8_t* buffer, uint16_t length)
+{
+  if (branchSpace() == 0U) {
+    DEBUG1("A fan-out output is full");
+    return 0x05U;
+  }
+
+  uint8_t delivered = 0U;
+  uint8_t ret = 0x00U;
+
+  for (uint8_t i = 0U; i < m_outputs; i++) {
+    uint8_t err = 0x00U;
+
+    if (m_branch[i] != PROCESSOR::NONE) {
+      err = stepInput(m_branch[i], buffer, length);
+    } else if (length != PCM_DATA_LENGTH) {
+      DEBUG2("PCM frame length is invalid", length);
+      err = 0x04U;
+    } else {
+      ::memcpy(m_pcm.next(), buffer, PCM_DATA_LENGTH);
+      m_pcm.push();
+    }
+
+    if (err == 0x00U)
+      delivered++;
+    else
+      ret = err;
+  }
+
+  m_branchPending += delivered;
+
+  // Only fail if none of the outputs will produce anything
+  return (delivered > 0U) ? 0x00U : ret;
+}
+
+FRAME_INFO CSession::removeInfo(uint8_t offset)
+{
+  FRAME_INFO info = {};
+
+  if (offset >= m_infoCount)
+    return info;
+
+  info = m_info[(m_infoHead + offset) % FRAME_INFO_DEPTH];
+
+  // Close the gap, keeping the remaining frames in order
+  for (uint8_t i = offset; i > 0U; i--)
+    m_info[(m_infoHead + i) % FRAME_INFO_DEPTH] = m_info[(m_infoHead + i - 1U) % FRAME_INFO_DEPTH];
+
+  m_infoHead = (m_infoHead + 1U) % FRAME_INFO_DEPTH;
+  m_infoCount--;
+
+  return info;
+}
+
+uint8_t CSession::initRoute(const ROUTE& route)
+{
+  m_stages = route.m_stages;
+
+  for (uint8_t i = 0U; i < m_stages; i++) {
+    m_step[i] = route.m_stage[i];
+    m_ambe[i] = usesAMBE(route.m_stage[i]);
+
+    uint8_t ret = initStep(m_step[i], m_channel[i]);
+    if (ret != 0x00U)
+      return ret;
+  }
+
+  return 0x00U;
+}
+
+uint8_t CSession::initStep(PROCESSOR type, int8_t& channel)
+{
+  if (type == PROCESSOR::NONE)
+    return 0x00U;
+
+  if (usesAMBE(type)) {
+    for (uint8_t n = 0U; n < AMBE_CHANNELS; n++) {
+      if ((channelsInUse & (1U << n)) == 0U) {
+        channelsInUse |= (1U << n);
+        stats.channelTaken(n);
+        channel = n;
+        return dispatch(*this, type, [=](auto& step) { return step.init(n); });
+      }
+    }
+
+    DEBUG1("No free AMBE channel for the session");
+    return 0x07U;
+  }
+
+  return dispatch(*this, type, [](auto& step) { return step.init(0U); });
+}
+
+void CSession::releaseStep(PROCESSOR type)
+{
+  dispatch(*this, type, [](auto& step) { step.release(); });
+}
@@ -0,0 +1,201 @@
+/*
+ *   Copyright (C) 2026 by Jonathan Naylor G4KLX
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef	Session_H
+#define	Session_H
+
+#include "Config.h"
+
+#include "ModeDefines.h"
+#include "FrameQueue.h"
+#include "Routes.h"
+
+#include "Codec23200IMBE.h"
+#include "IMBECodec23200.h"
+#include "Codec23200PCM.h"
+#include "PCMCodec23200.h"
+#include "YSFDNDMRNXDN.h"
+#include "DMRNXDNYSFDN.h"
+#include "IMBEIMBEFEC.h"
+#include "IMBEFECIMBE.h"
+#include "DMRNXDNFEC.h"
+#include "DMRNXDNPCM.h"
+#include "PCMDMRNXDN.h"
+#include "IMBEFECPCM.h"
+#include "PCMIMBEFEC.h"
+#include "PCMYSFDN.h"
+#include "YSFDNPCM.h"
+#include "YSFDNFEC.h"
+#include "DStarFEC.h"
+#include "DStarPCM.h"
+#include "PCMDStar.h"
+#include "MuLawPCM.h"
+#include "PCMMuLaw.h"
+#include "ALawPCM.h"
+#include "PCMALaw.h"
+#include "IMBEFEC.h"
+#include "IMBEPCM.h"
+#include "PCMIMBE.h"
+
+#include <cstdint>
+
+#if !defined(NUM_SESSIONS)
+#define NUM_SESSIONS  1
+#endif
+
+// Per frame bookkeeping, carried alongside the frame as it passes through the session
+struct FRAME_INFO {
+  bool     m_extended;      // Reply with the DATA header extension
+  uint16_t m_seq;           // Host sequence number, echoed back
+  uint32_t m_rx;            // Device timestamps in microseconds, zero if not applicable
+  uint32_t m_ambeWrite;
+  uint32_t m_ambeRead;
+};
+
+// Every frame in flight, in the AMBE chip and in the frame queues of all of the stages
+const uint8_t FRAME_INFO_DEPTH = MAX_STAGES * FRAME_QUEUE_DEPTH;
+
+// The most output modes that one input can be fanned out to
+const uint8_t MAX_FANOUT_OUTPUTS = 4U;
+
+class CSession {
+  public:
+    CSession();
+
+    uint8_t setMode(uint8_t input, uint8_t output);
+
+    // Decode the input to PCM once and encode it to each of the outputs
+    uint8_t setFanout(uint8_t input, const uint8_t* outputs, uint8_t count);
+
+    void    close();
+
+    // Drop every frame in flight, the session keeps its modes and channels
+    void    flush();
+
+    bool    isActive() const;
+
+    // True when the input and output modes are the same and no conversion is needed
+    bool    isIdentity() const;
+
+    bool    isFanout() const;
+
+    // True while any frames are still being processed
+    bool    hasFrames() const;
+
+    // True if any of the frames in flight will be returned with the DATA header extension
+    bool    hasExtended() const;
+
+    // The number of frames that the session can accept now
+    uint8_t space() const;
+
+    uint8_t input(const uint8_t* buffer, uint16_t length);
+    uint8_t input(const uint8_t* buffer, uint16_t length, const FRAME_INFO& info);
+
+    int16_t output(uint8_t* buffer);
+    int16_t output(uint8_t* buffer, FRAME_INFO& info);
+
+    // One output of a fan-out session, mode is the output mode that it belongs to
+    int16_t fanoutOutput(uint8_t* buffer, uint8_t& mode);
+
+  private:
+    bool           m_active;
+    uint8_t        m_stages;
+    PROCESSOR      m_step[MAX_STAGES];
+    int8_t         m_channel[MAX_STAGES];
+    bool           m_ambe[MAX_STAGES];
+    uint8_t        m_inStage[MAX_STAGES];
+    uint8_t        m_input;
+    uint8_t        m_output;
+    bool           m_silence;
+    uint8_t        m_silenceCount;
+
+    FRAME_INFO     m_info[FRAME_INFO_DEPTH];
+    uint8_t        m_infoHead;
+    uint8_t        m_infoCount;
+
+    uint8_t        m_outputs;
+    uint8_t        m_outputMode[MAX_FANOUT_OUTPUTS];
+    PROCESSOR      m_branch[MAX_FANOUT_OUTPUTS];
+    int8_t         m_branchChannel[MAX_FANOUT_OUTPUTS];
+    uint8_t        m_nextBranch;
+    uint8_t        m_branchPending;
+    CFrameQueue<PCM_DATA_LENGTH> m_pcm;
+
+    CDStarFEC      m_dstarfec;
+    CDMRNXDNFEC    m_dmrnxdnfec;
+    CYSFDNFEC      m_ysfdnfec;
+    CIMBEFEC       m_imbefec;
+
+#if AMBE_TYPE > 0
+    CYSFDNPCM      m_ysfdnpcm;
+    CDStarPCM      m_dstarpcm;
+    CDMRNXDNPCM    m_dmrnxdnpcm;
+#endif
+
+    CIMBEPCM       m_imbepcm;
+    CIMBEFECPCM    m_imbefecpcm;
+    CCodec23200PCM m_codec23200pcm;
+
+#if AMBE_TYPE > 0
+    CPCMYSFDN      m_pcmysfdn;
+    CPCMDStar      m_pcmdstar;
+    CPCMDMRNXDN    m_pcmdmrnxdn;
+#endif
+
+    CPCMIMBE       m_pcmimbe;
+    CPCMIMBEFEC    m_pcmimbefec;
+    CPCMCodec23200 m_pcmcodec23200;
+
+    CYSFDNDMRNXDN  m_ysfdndmrnxdn;
+    CDMRNXDNYSFDN  m_dmrnxdnysfdn;
+
+    CIMBEIMBEFEC   m_imbeimbefec;
+    CIMBEFECIMBE   m_imbefecimbe;
+
+#if defined(MODEL_TRANSCODING)
+    CIMBECodec23200 m_imbecodec23200;
+    CCodec23200IMBE m_codec23200imbe;
+#endif
+
+    CALawPCM       m_alawpcm;
+    CPCMALaw       m_pcmalaw;
+    CMuLawPCM      m_mulawpcm;
+    CPCMMuLaw      m_pcmmulaw;
+
+    // Call f with the processor for the type as its own final class so that the calls are bound
+    // at compile time, returns a zero value for no processor
+    template <class S, class F>
+    static decltype(auto) dispatch(S& session, PROCESSOR type, F f);
+
+    uint8_t     initRoute(const ROUTE& route);
+    uint8_t     initStep(PROCESSOR type, int8_t& channel);
+    void        releaseStep(PROCESSOR type);
+    FRAME_INFO  removeInfo(uint8_t offset);
+    uint8_t     stepSpace(PROCESSOR type) const;
+    uint8_t     stepInput(PROCESSOR type, const uint8_t* buffer, uint16_t length);
+    int16_t     stepOutput(PROCESSOR type, uint8_t* buffer);
+    int16_t     stepPeek(PROCESSOR type, uint8_t* scratch, const uint8_t*& frame);
+    void        stepDiscard(PROCESSOR type);
+    void        stepFlush(PROCESSOR type);
+    int16_t     transfer(uint8_t n, uint8_t* scratch, FRAME_INFO& info);
+    int16_t     peekOutput(uint8_t* scratch, const uint8_t*& frame, FRAME_INFO& info);
+    uint8_t     branchSpace() const;
+    uint8_t     branchInput(const uint8_t* buffer, uint16_t length);
+};
+
+#endif
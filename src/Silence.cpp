@@ -0,0 +1,161 @@
+/*
+ *   Copyright (C) 2026 by Jonathan Naylor G4KLX
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "Silence.h"
+
+#include "ModeDefines.h"
+#include "Config.h"
+
+#include <cstring>
+
+#if !defined(SILENCE_THRESHOLD)
+#define SILENCE_THRESHOLD  64
+#endif
+
+const uint8_t DSTAR_SILENCE[]    = {0x9EU, 0x8DU, 0x32U, 0x88U, 0x26U, 0x1AU, 0x3FU, 0x61U, 0xE8U};
+
+const uint8_t DMR_NXDN_SILENCE[] = {0xB9U, 0xE8U, 0x81U, 0x52U, 0x61U, 0x73U, 0x00U, 0x2AU, 0x6BU};
+
+// The DMR/NXDN silence after the conversion to YSF DN
+const uint8_t YSFDN_SILENCE[]    = {0xFFU, 0xFEU, 0x00U, 0x00U, 0x00U, 0x07U, 0xE3U, 0x8EU, 0x07U, 0xE0U, 0x7EU, 0x33U, 0x82U};
+
+const uint8_t IMBE_SILENCE[]     = {0x04U, 0x0CU, 0xFDU, 0x7BU, 0xFBU, 0x7DU, 0xF2U, 0x7BU, 0x3DU, 0x9EU, 0x45U};
+
+// The IMBE silence after the conversion to IMBE FEC
+const uint8_t IMBE_FEC_SILENCE[] = {0x6CU, 0x42U, 0xE8U, 0x5DU, 0xE2U, 0xE8U, 0x26U, 0x93U, 0x63U,
+                                    0xD9U, 0x81U, 0xF9U, 0xBEU, 0x23U, 0xB1U, 0x8AU, 0xE0U, 0x06U};
+
+// What the Codec2 encoder settles on for silent audio, as used by M17
+const uint8_t CODEC2_3200_SILENCE[] = {0x01U, 0x00U, 0x09U, 0x43U, 0x9CU, 0xE4U, 0x21U, 0x08U};
+
+// The G.711 codes of the silence level and the largest magnitude codes below the threshold
+const uint8_t ALAW_SILENCE  = 0xD5U;
+const uint8_t MULAW_SILENCE = 0xFFU;
+const uint8_t ALAW_QUIET    = (SILENCE_THRESHOLD - 8) / 16;
+const uint8_t MULAW_QUIET   = (SILENCE_THRESHOLD - 1) / 8;
+
+static const uint8_t* getCodeword(uint8_t mode, uint16_t& length)
+{
+  switch (mode) {
+    case MODE_DSTAR:
+      length = DSTAR_DATA_LENGTH;
+      return DSTAR_SILENCE;
+    case MODE_DMR_NXDN:
+      length = DMR_NXDN_DATA_LENGTH;
+      return DMR_NXDN_SILENCE;
+    case MODE_YSFDN:
+      length = YSFDN_DATA_LENGTH;
+      return YSFDN_SILENCE;
+    case MODE_IMBE:
+      length = IMBE_DATA_LENGTH;
+      return IMBE_SILENCE;
+    case MODE_IMBE_FEC:
+      length = IMBE_FEC_DATA_LENGTH;
+      return IMBE_FEC_SILENCE;
+    case MODE_CODEC2_3200:
+      length = CODEC2_3200_DATA_LENGTH;
+      return CODEC2_3200_SILENCE;
+    default:
+      length = 0U;
+      return nullptr;
+  }
+}
+
+bool CSilence::hasSilence(uint8_t mode)
+{
+  uint16_t length = 0U;
+
+  return (getCodeword(mode, length) != nullptr) || (mode == MODE_PCM) || (mode == MODE_ALAW) || (mode == MODE_MULAW);
+}
+
+bool CSilence::isSilence(uint8_t mode, const uint8_t* buffer, uint16_t length)
+{
+  switch (mode) {
+    case MODE_PCM: {
+        if (length != PCM_DATA_LENGTH)
+          return false;
+
+        const int16_t* audio = (const int16_t*)buffer;
+        for (uint16_t i = 0U; i < (PCM_DATA_LENGTH / sizeof(int16_t)); i++) {
+          if ((audio[i] >= SILENCE_THRESHOLD) || (audio[i] <= -SILENCE_THRESHOLD))
+            return false;
+        }
+
+        return true;
+      }
+
+    case MODE_ALAW:
+      if (length != ALAW_DATA_LENGTH)
+        return false;
+
+      // The low seven bits are the magnitude once the even bits are inverted
+      for (uint16_t i = 0U; i < ALAW_DATA_LENGTH; i++) {
+        if (((buffer[i] ^ ALAW_SILENCE) & 0x7FU) > ALAW_QUIET)
+          return false;
+      }
+
+      return true;
+
+    case MODE_MULAW:
+      if (length != MULAW_DATA_LENGTH)
+        return false;
+
+      // The low seven bits are the inverted magnitude
+      for (uint16_t i = 0U; i < MULAW_DATA_LENGTH; i++) {
+        if ((~buffer[i] & 0x7FU) > MULAW_QUIET)
+          return false;
+      }
+
+      return true;
+
+    default: {
+        uint16_t silenceLength = 0U;
+        const uint8_t* silence = getCodeword(mode, silenceLength);
+        if (silence == nullptr)
+          return false;
+
+        return (length == silenceLength) && (::memcmp(buffer, silence, silenceLength) == 0);
+      }
+  }
+}
+
+uint16_t CSilence::getSilence(uint8_t mode, uint8_t* buffer)
+{
+  switch (mode) {
+    case MODE_PCM:
+      ::memset(buffer, 0x00U, PCM_DATA_LENGTH);
+      return PCM_DATA_LENGTH;
+
+    case MODE_ALAW:
+      ::memset(buffer, ALAW_SILENCE, ALAW_DATA_LENGTH);
+      return ALAW_DATA_LENGTH;
+
+    case MODE_MULAW:
+      ::memset(buffer, MULAW_SILENCE, MULAW_DATA_LENGTH);
+      return MULAW_DATA_LENGTH;
+
+    default: {
+        uint16_t length = 0U;
+        const uint8_t* silence = getCodeword(mode, length);
+        if (silence != nullptr)
+          ::memcpy(buffer, silence, length);
+
+        return length;
+      }
+  }
+}
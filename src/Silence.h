@@ -0,0 +1,38 @@
+/*
+ *   Copyright (C) 2026 by Jonathan Naylor G4KLX
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef	Silence_H
+#define	Silence_H
+
+#include <cstdint>
+
+class CSilence {
+  public:
+    // True if the mode has a silence frame that can be recognised and generated
+    static bool     hasSilence(uint8_t mode);
+
+    // True for the silence codeword of a vocoder mode, or audio below the threshold
+    static bool     isSilence(uint8_t mode, const uint8_t* buffer, uint16_t length);
+
+    // Write the canonical silence frame of the mode, returns its length
+    static uint16_t getSilence(uint8_t mode, uint8_t* buffer);
+
+  private:
+};
+
+#endif
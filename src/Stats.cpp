@@ -0,0 +1,219 @@
+/*
+ *   Copyright (C) 2026 by Jonathan Naylor G4KLX
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "Stats.h"
+
+static uint16_t put(uint8_t* buffer, uint16_t pos, uint32_t value)
+{
+  buffer[pos + 0U] = (value >> 0)  & 0xFFU;
+  buffer[pos + 1U] = (value >> 8)  & 0xFFU;
+  buffer[pos + 2U] = (value >> 16) & 0xFFU;
+  buffer[pos + 3U] = (value >> 24) & 0xFFU;
+
+  return pos + 4U;
+}
+
+CStats::CStats() :
+m_framesIn(),
+m_framesOut(),
+m_naks(),
+m_fecCorrections(0U),
+m_dvsiSent(0U),
+m_dvsiReceived(0U),
+m_rtsBusy(0U),
+m_maxLoopTime(0U),
+m_stageCount(),
+m_stageMax(),
+m_stageTotal(),
+m_channelFrames(),
+m_channelHeld(),
+m_channelStart(),
+m_channelsTaken(0x0000U)
+{
+}
+
+void CStats::start()
+{
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+
+  // The Cortex-M7 DWT is locked after reset
+  DWT->LAR    = 0xC5ACCE55U;
+  DWT->CYCCNT = 0U;
+  DWT->CTRL  |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+void CStats::reset()
+{
+  for (uint8_t i = 0U; i < NUM_SESSIONS; i++) {
+    m_framesIn[i]  = 0U;
+    m_framesOut[i] = 0U;
+  }
+
+  for (uint8_t i = 0U; i < STATS_NAKS; i++)
+    m_naks[i] = 0U;
+
+  m_fecCorrections = 0U;
+  m_dvsiSent       = 0U;
+  m_dvsiReceived   = 0U;
+  m_rtsBusy        = 0U;
+  m_maxLoopTime    = 0U;
+
+  for (uint8_t i = 0U; i < STATS_STAGES; i++) {
+    m_stageCount[i] = 0U;
+    m_stageMax[i]   = 0U;
+    m_stageTotal[i] = 0U;
+  }
+
+  // A channel still held starts its time again from now
+  uint32_t now = millis();
+  for (uint8_t i = 0U; i < STATS_CHANNELS; i++) {
+    m_channelFrames[i] = 0U;
+    m_channelHeld[i]   = 0U;
+    m_channelStart[i]  = now;
+  }
+}
+
+void CStats::frameIn(uint8_t id, uint8_t count)
+{
+  if (id < NUM_SESSIONS)
+    m_framesIn[id] += count;
+}
+
+void CStats::frameOut(uint8_t id, uint8_t count)
+{
+  if (id < NUM_SESSIONS)
+    m_framesOut[id] += count;
+}
+
+void CStats::nak(uint8_t err)
+{
+  if (err < STATS_NAKS)
+    m_naks[err]++;
+}
+
+void CStats::fecCorrections(uint8_t bits)
+{
+  m_fecCorrections += bits;
+}
+
+void CStats::dvsiSent()
+{
+  m_dvsiSent++;
+}
+
+void CStats::dvsiReceived()
+{
+  m_dvsiReceived++;
+}
+
+void CStats::rtsBusy()
+{
+  m_rtsBusy++;
+}
+
+void CStats::channelTaken(uint8_t n)
+{
+  if (n >= STATS_CHANNELS)
+    return;
+
+  m_channelsTaken  |= (1U << n);
+  m_channelStart[n] = millis();
+}
+
+void CStats::channelReleased(uint8_t n)
+{
+  if (n >= STATS_CHANNELS)
+    return;
+
+  m_channelHeld[n] = channelHeld(n);
+  m_channelsTaken &= ~(1U << n);
+}
+
+void CStats::channelFrame(uint8_t n)
+{
+  if (n < STATS_CHANNELS)
+    m_channelFrames[n]++;
+}
+
+uint32_t CStats::channelHeld(uint8_t n) const
+{
+  if ((m_channelsTaken & (1U << n)) == 0U)
+    return m_channelHeld[n];
+
+  return m_channelHeld[n] + (millis() - m_channelStart[n]);
+}
+
+void CStats::loopTime(uint32_t us)
+{
+  if (us > m_maxLoopTime)
+    m_maxLoopTime = us;
+}
+
+void CStats::stage(STAGE stage, uint32_t start)
+{
+  uint32_t elapsed = cycles() - start;
+
+  uint8_t n = uint8_t(stage);
+
+  m_stageCount[n]++;
+  m_stageTotal[n] += elapsed;
+  if (elapsed > m_stageMax[n])
+    m_stageMax[n] = elapsed;
+}
+
+uint16_t CStats::get(uint8_t* buffer) const
+{
+  uint16_t pos = 0U;
+
+  buffer[pos++] = NUM_SESSIONS;
+
+  // Allows the host to convert cycles to time
+  pos = put(buffer, pos, SystemCoreClock);
+
+  for (uint8_t i = 0U; i < NUM_SESSIONS; i++) {
+    pos = put(buffer, pos, m_framesIn[i]);
+    pos = put(buffer, pos, m_framesOut[i]);
+  }
+
+  for (uint8_t i = 0U; i < STATS_NAKS; i++)
+    pos = put(buffer, pos, m_naks[i]);
+
+  pos = put(buffer, pos, m_fecCorrections);
+  pos = put(buffer, pos, m_dvsiSent);
+  pos = put(buffer, pos, m_dvsiReceived);
+  pos = put(buffer, pos, m_rtsBusy);
+  pos = put(buffer, pos, m_maxLoopTime);
+
+  for (uint8_t i = 0U; i < STATS_STAGES; i++) {
+    uint32_t average = (m_stageCount[i] > 0U) ? uint32_t(m_stageTotal[i] / m_stageCount[i]) : 0U;
+
+    pos = put(buffer, pos, m_stageCount[i]);
+    pos = put(buffer, pos, m_stageMax[i]);
+    pos = put(buffer, pos, average);
+  }
+
+  // The number of channels varies with the board, so the host needs it to find the end of the reply
+  buffer[pos++] = STATS_CHANNELS;
+
+  for (uint8_t i = 0U; i < STATS_CHANNELS; i++) {
+    pos = put(buffer, pos, m_channelFrames[i]);
+    pos = put(buffer, pos, channelHeld(i));
+  }
+
+  return pos;
+}
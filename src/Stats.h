@@ -0,0 +1,108 @@
+/*
+ *   Copyright (C) 2026 by Jonathan Naylor G4KLX
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef	Stats_H
+#define	Stats_H
+
+#include "Config.h"
+
+#include <Arduino.h>
+
+#include <cstdint>
+
+#if !defined(NUM_SESSIONS)
+#define NUM_SESSIONS  1
+#endif
+
+// The code sections timed with the DWT cycle counter
+enum class STAGE : uint8_t {
+  PROCESSOR_INPUT,
+  PROCESSOR_OUTPUT,
+  IMBE_ENCODE,
+  CODEC2_ENCODE
+};
+
+const uint8_t STATS_STAGES = 4U;
+const uint8_t STATS_NAKS   = 8U;
+
+// The DVSI vocoder channels reported, a board with fewer than three reports the unused ones as zero
+#if AMBE_TYPE == 3 && AMBE3003_CHIPS > 1
+const uint8_t STATS_CHANNELS = AMBE3003_CHIPS * 3U;
+#else
+const uint8_t STATS_CHANNELS = 3U;
+#endif
+
+class CStats {
+  public:
+    CStats();
+
+    // Enable the Cortex-M7 cycle counter
+    void start();
+
+    void reset();
+
+    void frameIn(uint8_t id, uint8_t count = 1U);
+    void frameOut(uint8_t id, uint8_t count = 1U);
+
+    void nak(uint8_t err);
+
+    void fecCorrections(uint8_t bits);
+
+    void dvsiSent();
+    void dvsiReceived();
+
+    void rtsBusy();
+
+    // A DVSI channel taken by a session or given back, and a frame written to it
+    void channelTaken(uint8_t n);
+    void channelReleased(uint8_t n);
+    void channelFrame(uint8_t n);
+
+    void loopTime(uint32_t us);
+
+    static uint32_t cycles()
+    {
+      return DWT->CYCCNT;
+    }
+
+    void stage(STAGE stage, uint32_t start);
+
+    // Serialise the counters as little endian 32 bit values, returns the length
+    uint16_t get(uint8_t* buffer) const;
+
+  private:
+    uint32_t m_framesIn[NUM_SESSIONS];
+    uint32_t m_framesOut[NUM_SESSIONS];
+    uint32_t m_naks[STATS_NAKS];
+    uint32_t m_fecCorrections;
+    uint32_t m_dvsiSent;
+    uint32_t m_dvsiReceived;
+    uint32_t m_rtsBusy;
+    uint32_t m_maxLoopTime;
+    uint32_t m_stageCount[STATS_STAGES];
+    uint32_t m_stageMax[STATS_STAGES];
+    uint64_t m_stageTotal[STATS_STAGES];
+    uint32_t m_channelFrames[STATS_CHANNELS];
+    uint32_t m_channelHeld[STATS_CHANNELS];
+    uint32_t m_channelStart[STATS_CHANNELS];
+    uint16_t m_channelsTaken;
+
+    uint32_t channelHeld(uint8_t n) const;
+};
+
+#endif
@@ -0,0 +1,100 @@
+/*
+ *   Copyright (C) 2026 by Jonathan Naylor G4KLX
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "Trace.h"
+
+#include <Arduino.h>
+
+CTrace::CTrace() :
+m_entries(),
+m_head(0U),
+m_tail(0U),
+m_dropped(0U)
+{
+}
+
+void CTrace::log(const char* text)
+{
+  add(text, 0U, 0, 0, 0, 0);
+}
+
+void CTrace::log(const char* text, int16_t n1)
+{
+  add(text, 1U, n1, 0, 0, 0);
+}
+
+void CTrace::log(const char* text, int16_t n1, int16_t n2)
+{
+  add(text, 2U, n1, n2, 0, 0);
+}
+
+void CTrace::log(const char* text, int16_t n1, int16_t n2, int16_t n3)
+{
+  add(text, 3U, n1, n2, n3, 0);
+}
+
+void CTrace::log(const char* text, int16_t n1, int16_t n2, int16_t n3, int16_t n4)
+{
+  add(text, 4U, n1, n2, n3, n4);
+}
+
+bool CTrace::isEmpty() const
+{
+  return m_head == m_tail;
+}
+
+const TRACE_ENTRY& CTrace::peek() const
+{
+  return m_entries[m_tail];
+}
+
+void CTrace::pop()
+{
+  if (m_head != m_tail)
+    m_tail = (m_tail + 1U) % TRACE_LENGTH;
+}
+
+uint16_t CTrace::getDropped()
+{
+  uint16_t dropped = m_dropped;
+  m_dropped = 0U;
+
+  return dropped;
+}
+
+void CTrace::add(const char* text, uint8_t count, int16_t n1, int16_t n2, int16_t n3, int16_t n4)
+{
+  uint16_t next = (m_head + 1U) % TRACE_LENGTH;
+  if (next == m_tail) {
+    if (m_dropped < 0xFFFFU)
+      m_dropped++;
+    return;
+  }
+
+  TRACE_ENTRY& entry = m_entries[m_head];
+  entry.m_text     = text;
+  entry.m_time     = micros();
+  entry.m_count    = count;
+  entry.m_args[0U] = n1;
+  entry.m_args[1U] = n2;
+  entry.m_args[2U] = n3;
+  entry.m_args[3U] = n4;
+
+  // Only publish the record once it is complete
+  m_head = next;
+}
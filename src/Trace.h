@@ -0,0 +1,73 @@
+/*
+ *   Copyright (C) 2026 by Jonathan Naylor G4KLX
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef	Trace_H
+#define	Trace_H
+
+#include "Config.h"
+
+#include <cstdint>
+
+#if !defined(TRACE_LENGTH)
+#define TRACE_LENGTH  64
+#endif
+
+const uint8_t TRACE_MAX_ARGS = 4U;
+
+// The text is a string literal so its address identifies the event, it is
+// only looked at when the record is drained
+struct TRACE_ENTRY {
+  const char* m_text;
+  uint32_t    m_time;
+  uint8_t     m_count;
+  int16_t     m_args[TRACE_MAX_ARGS];
+};
+
+// A single producer, single consumer ring of debug records. Logging only
+// stores the record, the formatting and output happen when it is drained.
+// When the ring is full new records are dropped and counted.
+class CTrace {
+  public:
+    CTrace();
+
+    void log(const char* text);
+    void log(const char* text, int16_t n1);
+    void log(const char* text, int16_t n1, int16_t n2);
+    void log(const char* text, int16_t n1, int16_t n2, int16_t n3);
+    void log(const char* text, int16_t n1, int16_t n2, int16_t n3, int16_t n4);
+
+    bool isEmpty() const;
+
+    // The oldest record, only valid until pop() is called
+    const TRACE_ENTRY& peek() const;
+
+    void pop();
+
+    // The number of records lost since the last call
+    uint16_t getDropped();
+
+  private:
+    TRACE_ENTRY       m_entries[TRACE_LENGTH];
+    volatile uint16_t m_head;
+    volatile uint16_t m_tail;
+    volatile uint16_t m_dropped;
+
+    void add(const char* text, uint8_t count, int16_t n1, int16_t n2, int16_t n3, int16_t n4);
+};
+
+#endif
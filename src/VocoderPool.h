@@ -0,0 +1,136 @@
+/*
+ *   Copyright (C) 2026 by Jonathan Naylor G4KLX
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef	VocoderPool_H
+#define	VocoderPool_H
+
+#include "IMBE/imbe_vocoder.h"
+
+#include "Codec2/codec2.h"
+
+#include <cstdint>
+
+// The calls that the pool needs, under the names that each vocoder library uses
+inline void vocoderReset(imbe_vocoder& vocoder)                          { vocoder.reset(); }
+inline void vocoderReset(CCodec2& vocoder)                               { vocoder.codec2_reset(); }
+inline void vocoderGetState(const imbe_vocoder& vocoder, uint8_t* state) { vocoder.get_state(state); }
+inline void vocoderGetState(const CCodec2& vocoder, uint8_t* state)      { vocoder.codec2_get_state(state); }
+inline void vocoderSetState(imbe_vocoder& vocoder, const uint8_t* state) { vocoder.set_state(state); }
+inline void vocoderSetState(CCodec2& vocoder, const uint8_t* state)      { vocoder.codec2_set_state(state); }
+
+// STREAMS logical vocoder streams time sliced onto INSTANCES vocoders. Each stream
+// has LENGTH bytes to hold its state while it is not loaded into a vocoder. A
+// stream keeps its vocoder until another stream needs one and this stream is the
+// least recently used, so while there are no more busy streams than vocoders no
+// state is ever copied.
+template <class T, uint8_t INSTANCES, uint8_t STREAMS, uint16_t LENGTH>
+class CVocoderPool {
+  public:
+    CVocoderPool() :
+    m_vocoders(),
+    m_owner(),
+    m_lastUse(),
+    m_state(),
+    m_inUse(0U),
+    m_fresh(0U),
+    m_tick(0U)
+    {
+      static_assert(STREAMS <= 32U, "Too many vocoder streams");
+
+      for (uint8_t i = 0U; i < INSTANCES; i++)
+        m_owner[i] = -1;
+    }
+
+    // Take a stream whose state starts from reset, -1 if all are in use
+    int8_t allocate()
+    {
+      for (uint8_t i = 0U; i < STREAMS; i++) {
+        if ((m_inUse & (1U << i)) == 0U) {
+          m_inUse |= (1U << i);
+          m_fresh |= (1U << i);
+          return i;
+        }
+      }
+
+      return -1;
+    }
+
+    void release(int8_t stream)
+    {
+      if (stream < 0)
+        return;
+
+      m_inUse &= ~(1U << stream);
+
+      for (uint8_t i = 0U; i < INSTANCES; i++) {
+        if (m_owner[i] == stream)
+          m_owner[i] = -1;
+      }
+    }
+
+    // A vocoder holding the state of the stream, valid until the next call
+    T* get(int8_t stream)
+    {
+      m_tick++;
+
+      for (uint8_t i = 0U; i < INSTANCES; i++) {
+        if (m_owner[i] == stream) {
+          m_lastUse[i] = m_tick;
+          return &m_vocoders[i];
+        }
+      }
+
+      // Use an idle vocoder if there is one, else the least recently used
+      uint8_t n = 0U;
+      for (uint8_t i = 0U; i < INSTANCES; i++) {
+        if (m_owner[i] < 0) {
+          n = i;
+          break;
+        }
+
+        if ((m_tick - m_lastUse[i]) > (m_tick - m_lastUse[n]))
+          n = i;
+      }
+
+      if (m_owner[n] >= 0)
+        vocoderGetState(m_vocoders[n], m_state[m_owner[n]]);
+
+      if ((m_fresh & (1U << stream)) != 0U) {
+        vocoderReset(m_vocoders[n]);
+        m_fresh &= ~(1U << stream);
+      } else {
+        vocoderSetState(m_vocoders[n], m_state[stream]);
+      }
+
+      m_owner[n]   = stream;
+      m_lastUse[n] = m_tick;
+
+      return &m_vocoders[n];
+    }
+
+  private:
+    T        m_vocoders[INSTANCES];
+    int8_t   m_owner[INSTANCES];
+    uint32_t m_lastUse[INSTANCES];
+    uint8_t  m_state[STREAMS][LENGTH];
+    uint32_t m_inUse;
+    uint32_t m_fresh;
+    uint32_t m_tick;
+};
+
+#endif
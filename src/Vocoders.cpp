@@ -0,0 +1,65 @@
+/*
+ *   Copyright (C) 2026 by Jonathan Naylor G4KLX
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "Vocoders.h"
+
+#include "Debug.h"
+
+CVocoders::CVocoders() :
+m_imbe(),
+m_codec2()
+{
+}
+
+int8_t CVocoders::allocateIMBE()
+{
+  int8_t stream = m_imbe.allocate();
+  if (stream < 0)
+    DEBUG1("No free IMBE vocoder stream");
+
+  return stream;
+}
+
+int8_t CVocoders::allocateCodec2()
+{
+  int8_t stream = m_codec2.allocate();
+  if (stream < 0)
+    DEBUG1("No free Codec2 vocoder stream");
+
+  return stream;
+}
+
+void CVocoders::releaseIMBE(int8_t stream)
+{
+  m_imbe.release(stream);
+}
+
+void CVocoders::releaseCodec2(int8_t stream)
+{
+  m_codec2.release(stream);
+}
+
+imbe_vocoder* CVocoders::getIMBE(int8_t stream)
+{
+  return m_imbe.get(stream);
+}
+
+CCodec2* CVocoders::getCodec2(int8_t stream)
+{
+  return m_codec2.get(stream);
+}
@@ -0,0 +1,65 @@
+/*
+ *   Copyright (C) 2026 by Jonathan Naylor G4KLX
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef	Vocoders_H
+#define	Vocoders_H
+
+#include "Config.h"
+
+#include "VocoderPool.h"
+
+#include <cstdint>
+
+#if !defined(NUM_IMBE_VOCODERS)
+#define NUM_IMBE_VOCODERS  1
+#endif
+
+#if !defined(NUM_IMBE_STREAMS)
+#define NUM_IMBE_STREAMS  NUM_IMBE_VOCODERS
+#endif
+
+#if !defined(NUM_CODEC2_VOCODERS)
+#define NUM_CODEC2_VOCODERS  1
+#endif
+
+#if !defined(NUM_CODEC2_STREAMS)
+#define NUM_CODEC2_STREAMS  NUM_CODEC2_VOCODERS
+#endif
+
+// The software vocoder streams, each one is owned by a single processor while a session uses it
+class CVocoders {
+  public:
+    CVocoders();
+
+    // Take a stream whose state starts from reset, -1 if all are in use
+    int8_t allocateIMBE();
+    int8_t allocateCodec2();
+
+    void releaseIMBE(int8_t stream);
+    void releaseCodec2(int8_t stream);
+
+    // The vocoder to use for the next frame of the stream
+    imbe_vocoder* getIMBE(int8_t stream);
+    CCodec2*      getCodec2(int8_t stream);
+
+  private:
+    CVocoderPool<imbe_vocoder, NUM_IMBE_VOCODERS, NUM_IMBE_STREAMS, IMBE_STATE_LENGTH>     m_imbe;
+    CVocoderPool<CCodec2, NUM_CODEC2_VOCODERS, NUM_CODEC2_STREAMS, CODEC2_STATE_LENGTH> m_codec2;
+};
+
+#endif
@@ -19,21 +19,18 @@
 #ifndef	YSFDNDMRNXDN_H
 #define	YSFDNDMRNXDN_H
 
-#include "Processor.h"
+#include "QueuedProcessor.h"
 
 #include "ModeDefines.h"
 
-class CYSFDNDMRNXDN : public IProcessor {
+class CYSFDNDMRNXDN final : public CQueuedProcessor<DMR_NXDN_DATA_LENGTH> {
   public:
     CYSFDNDMRNXDN();
     virtual ~CYSFDNDMRNXDN();
 
     virtual uint8_t input(const uint8_t* buffer, uint16_t length) override;
 
-    virtual int16_t output(uint8_t* buffer) override;
-
   private:
-    uint8_t m_buffer[DMR_NXDN_DATA_LENGTH];
-    bool    m_inUse;};
+};
 
 #endif
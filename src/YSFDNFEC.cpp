@@ -22,8 +22,7 @@
 #include "Debug.h"
 
 CYSFDNFEC::CYSFDNFEC() :
-m_buffer(),
-m_inUse(false)
+CQueuedProcessor()
 {
 }
 
@@ -33,8 +32,8 @@ CYSFDNFEC::~CYSFDNFEC()
 
 uint8_t CYSFDNFEC::input(const uint8_t* buffer, uint16_t length)
 {
-  if (m_inUse) {
-    DEBUG1("YSF DN frame is being overwritten");
+  if (m_queue.isFull()) {
+    DEBUG1("YSF DN frame queue is full");
     return 0x05U;
   }
 
@@ -43,22 +42,13 @@ uint8_t CYSFDNFEC::input(const uint8_t* buffer, uint16_t length)
     return 0x04U;
   }
 
+  uint8_t* out = m_queue.next();
+
   uint8_t ambe[10U];
   CYSFDNUtils::toMode34(buffer, ambe);
-  CYSFDNUtils::fromMode34(ambe, m_buffer);
+  CYSFDNUtils::fromMode34(ambe, out);
 
-  m_inUse = true;
+  m_queue.push();
 
   return 0x00U;
 }
-
-int16_t CYSFDNFEC::output(uint8_t* buffer)
-{
-  if (!m_inUse)
-    return 0;
-
-  ::memcpy(buffer, m_buffer, YSFDN_DATA_LENGTH);
-  m_inUse = false;
-
-  return YSFDN_DATA_LENGTH;
-}
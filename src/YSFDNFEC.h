@@ -19,22 +19,18 @@
 #ifndef	YSFDNFEC_H
 #define	YSFDNFEC_H
 
-#include "Processor.h"
+#include "QueuedProcessor.h"
 
 #include "ModeDefines.h"
 
-class CYSFDNFEC : public IProcessor {
+class CYSFDNFEC final : public CQueuedProcessor<YSFDN_DATA_LENGTH> {
   public:
     CYSFDNFEC();
     virtual ~CYSFDNFEC();
 
     virtual uint8_t input(const uint8_t* buffer, uint16_t length) override;
 
-    virtual int16_t output(uint8_t* buffer) override;
-
   private:
-    uint8_t m_buffer[YSFDN_DATA_LENGTH];
-    bool    m_inUse;
 };
 
 #endif
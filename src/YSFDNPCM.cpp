@@ -38,9 +38,7 @@ uint8_t CYSFDNPCM::init(uint8_t n)
 {
   m_n = n;
 
-  ambe.init(m_n, AMBE_MODE::YSFDN_TO_PCM);
-
-  return 0x00U;
+  return ambe.init(m_n, AMBE_MODE::YSFDN_TO_PCM);
 }
 
 uint8_t CYSFDNPCM::input(const uint8_t* buffer, uint16_t length)
@@ -72,4 +70,14 @@ int16_t CYSFDNPCM::output(uint8_t* buffer)
   }
 }
 
+void CYSFDNPCM::flush()
+{
+  ambe.drain(m_n);
+}
+
+uint8_t CYSFDNPCM::space() const
+{
+  return ambe.space(m_n);
+}
+
 #endif
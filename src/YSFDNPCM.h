@@ -25,7 +25,7 @@
 
 #include "Processor.h"
 
-class CYSFDNPCM : public IProcessor {
+class CYSFDNPCM final : public IProcessor {
   public:
     CYSFDNPCM();
     virtual ~CYSFDNPCM();
@@ -36,6 +36,10 @@ class CYSFDNPCM : public IProcessor {
 
     virtual int16_t output(uint8_t* buffer) override;
 
+    virtual void    flush() override;
+
+    virtual uint8_t space() const override;
+
   private:
     uint8_t m_n;
 };